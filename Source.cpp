@@ -19,41 +19,49 @@
 */
 
 #include "UserClasses.h"
+#include "accountStore.h"
+#include "bankFunctions.h"
+#include "binaryAccountFile.h"
+#include "batchProcessor.h"
+#include "datasetGenerator.h"
+#include "sessionServer.h"
+#include "accountTable.h"
+#include "recordParser.h"
+#include "statementWriter.h"
+#include "terminalScreen.h"
+#include "operationMetrics.h"
+#include "traceLog.h"
 #include <iostream>
 #include <string>
-#include <random>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
 
 #pragma region Function prototypes: Not logged in
 int welcome();
-bool login(customer& _user, std::fstream& _userData, std::fstream& _userAccountData, checkingAccount& _userChecking, savingAccount& _userSaving);
-void signUp(std::fstream& _userData);
+bool login(customerHandle& _user, accountStore& _store, checkingAccount& _userChecking, savingAccount& _userSaving);
+void signUp(accountStore& _store);
 #pragma endregion
 
 #pragma region Function prototypes: Logged in
-int options(customer _user);
-void createAccount(customer _user, checkingAccount& _userChecking, savingAccount& _userSaving, std::fstream& _userAccountData);
-void displayAccount(checkingAccount _userChecking, savingAccount _userSaving);
-void withdrawAccount(customer _user, checkingAccount& _userChecking, savingAccount& _userSaving, std::fstream& _userAccountData);
-void depositAccount(customer _user, checkingAccount& _userChecking, savingAccount& _userSaving, std::fstream& _userAccountData);
-bool logout(customer& _user, checkingAccount& _userChecking, savingAccount& _userSaving);
+int options(const customer& _user);
+void createAccount(const customerHandle& _user, checkingAccount& _userChecking, savingAccount& _userSaving, accountStore& _store);
+void displayAccount(const checkingAccount& _userChecking, const savingAccount& _userSaving);
+void withdrawAccount(checkingAccount& _userChecking, savingAccount& _userSaving, accountStore& _store);
+void depositAccount(checkingAccount& _userChecking, savingAccount& _userSaving, accountStore& _store);
+bool logout(customerHandle& _user, checkingAccount& _userChecking, savingAccount& _userSaving);
 #pragma endregion
 
 #pragma region Function prototypes: Other functions
-bool loadUser(customer& _user, std::fstream& _userData, std::string _passwordInput, std::string _usernameInput);
-void loadAccounts(customer _user, checkingAccount& _userChecking, savingAccount& _userSaving, std::fstream& _userAccountData);
+// The rest are declared in bankFunctions.h
 std::string inputPasswd(bool& _valid);
-bool userExistance(std::fstream& _userData, std::string _usernameInput);
-bool savingExistance(std::fstream& _userAccountData, customer _user);
-bool checkingExistance(std::fstream& _userAccountData, customer _user);
-void createSaving(std::fstream& _userAccountData, customer _user, savingAccount& _userSaving);
-void createChecking(std::fstream& _userAccountData, customer _user, checkingAccount& _userChecking);
-void updateSavingAccount(customer _user, savingAccount _userSaving, std::fstream& _userAccountData);
-void updateCheckingAccount(customer _user, checkingAccount _userChecking, std::fstream& _userAccountData);
+void displayMetrics();
+bool saveMetrics(const std::string& _metricsPath);
 #pragma endregion
 
-int main()
+int main(int argc, char* argv[])
 {
 	/*
 		The main function displays menus available to the user depending on if that
@@ -66,21 +74,276 @@ int main()
 		The exit variable will exit the do while loop that keeps the program running if the user selects 3 from the welcome menu.
 
 		user, userChecking, and userSaving are the classes that are loaded/unloaded with data when logged in or logged out.
-
-		userData and userAccountData are the file streams for storing and retrieving data from text files.
+		user is a handle to the profile held by the store, so it is shared instead of copied.
+
+		screen gathers each menu into one write to the terminal and clears it with escape sequences,
+		and the menus are answered with a single keypress.
+
+		store holds every profile and account in memory. It is loaded from userData.txt, userAccountData.txt
+		and userAccountLog.txt once at startup; after that the text files are only written to, for persistence.
+		Every deposit, withdrawal, overdraft fee and interest payment is also kept in each account's history,
+		in userLedger.journal and userLedger.blocks.
+
+		Command line options:
+			--binary: keeps accounts in the memory-mapped userAccountData.bin instead of the text files,
+				creating it from userAccountData.txt and userAccountLog.txt the first time
+			--convert: converts userAccountData.txt and userAccountLog.txt into userAccountData.bin and exits
+			--batch <transactions> <results>: applies a transaction file without the menus, writes a result file and exits
+			--generate [key=value ...]: writes a synthetic userData.txt, userAccountData.txt and transaction file and exits
+				keys: customers, saving, checking (percent of customers), transactions, hot, hotshare (percent), threads, seed, out
+			--serve [port]: serves concurrent client sessions on 127.0.0.1 (port 5050 by default) instead of the menus,
+				until the process gets SIGINT or SIGTERM
+			--post-interest [threads]: saves the interest accrued up to today on every saving account across worker threads, saves once and exits
+			--report: prints total deposits, overdraft exposure and a balance histogram over every account and exits
+			--lookup <id>: prints the saving or checking account with the ID, found through the store's ID index, and exits
+			--statement <id> <from> <to>: prints the statement of the account with the ID from one YYYY-MM-DD date to another and exits
+			--statements <from> <to> [directory] [threads]: writes every account's statement for the period into
+				directory (statements by default) across worker threads, one file per thread, and exits
+			--commit-delay <microseconds>: how long a group commit waits for more concurrent writes before its fsync (0 by default)
+			--metrics-file <path>: writes the latency percentiles of every timed banking operation to path on exit
+				after the menus, --serve or --batch; the menus also show them on the unlisted selection 9
+			--trace <path>: records spans for the file reads, parsing, log appends, fsyncs and renames of the run and writes them
+				to path on exit, or once --serve has shut down, as Chrome trace-event JSON, for chrome://tracing or Perfetto
 	*/
 
 	int navigator = NULL;
 	bool currentlyLogged = false;
 	bool exit = false;
 
-	customer user;
+	customerHandle user;
 	checkingAccount userChecking;
 	savingAccount userSaving;
 
-	std::fstream userData;
-	std::fstream userAccountData;
+	accountStore store;
+	std::string batchPath, batchResultPath;
+	bool serve = false;
+	unsigned short serverPort = 5050;
+	bool postInterest = false;
+	bool report = false;
+	int lookupId = 0;
+	int statementId = 0;
+	bool statements = false;
+	std::string statementFrom, statementTo, statementDirectory = "statements";
+	unsigned statementThreads = std::max(1u, std::thread::hardware_concurrency());
+	unsigned interestThreads = std::max(1u, std::thread::hardware_concurrency());
+	std::string metricsPath, tracePath;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+		if (option == "--binary")
+		{
+			store.setbinaryPath("userAccountData.bin");
+		}
+		else if (option == "--convert")
+		{
+			if (binaryAccountFile::convertTextFile("userAccountData.txt", "userAccountLog.txt.sealed", "userAccountLog.txt", "userAccountData.bin") == false)
+			{
+				std::cout << "ERROR: File handling\n";
+				return 1;
+			}
+			std::cout << "Converted userAccountData.txt to userAccountData.bin\n";
+			return 0;
+		}
+		else if (option == "--generate")
+		{
+			generatorOptions options = defaultGeneratorOptions();
+			while (i + 1 < argc && std::string(argv[i + 1]).find('=') != std::string::npos)
+			{
+				i++;
+				if (parseGeneratorOption(argv[i], options) == false)
+				{
+					std::cout << "Unknown generator option " << argv[i] << "\n";
+					return 1;
+				}
+			}
+			if (generateDataset(options) == false)
+			{
+				std::cout << "ERROR: File handling\n";
+				return 1;
+			}
+			std::cout << "Generated " << options.customers << " customers and " << options.transactions << " transactions\n";
+			return 0;
+		}
+		else if (option == "--batch" && i + 2 < argc)
+		{
+			batchPath = argv[i + 1];
+			batchResultPath = argv[i + 2];
+			i += 2;
+		}
+		else if (option == "--report")
+		{
+			report = true;
+		}
+		else if (option == "--post-interest")
+		{
+			postInterest = true;
+			if (i + 1 < argc && (std::stringstream(argv[i + 1]) >> interestThreads))
+			{
+				i++;
+			}
+		}
+		else if (option == "--lookup" && i + 1 < argc)
+		{
+			std::stringstream(argv[i + 1]) >> lookupId;
+			i++;
+		}
+		else if (option == "--statement" && i + 3 < argc)
+		{
+			std::stringstream(argv[i + 1]) >> statementId;
+			statementFrom = argv[i + 2];
+			statementTo = argv[i + 3];
+			i += 3;
+		}
+		else if (option == "--statements" && i + 2 < argc)
+		{
+			statements = true;
+			statementFrom = argv[i + 1];
+			statementTo = argv[i + 2];
+			i += 2;
+			if (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0)
+			{
+				statementDirectory = argv[i + 1];
+				i++;
+			}
+			if (i + 1 < argc && (std::stringstream(argv[i + 1]) >> statementThreads))
+			{
+				i++;
+			}
+		}
+		else if (option == "--commit-delay" && i + 1 < argc)
+		{
+			long long commitDelay = 0;
+			if (std::stringstream(argv[i + 1]) >> commitDelay)
+			{
+				store.setcommitDelay(std::chrono::microseconds(commitDelay));
+			}
+			i++;
+		}
+		else if (option == "--metrics-file" && i + 1 < argc)
+		{
+			metricsPath = argv[++i];
+		}
+		else if (option == "--trace" && i + 1 < argc)
+		{
+			tracePath = argv[++i];
+		}
+		else if (option == "--serve")
+		{
+			serve = true;
+			if (i + 1 < argc && (std::stringstream(argv[i + 1]) >> serverPort))
+			{
+				i++;
+			}
+		}
+	}
+
+	// Written when main returns, whichever command ran; under --serve that is after the server has shut down and every
+	// session has ended, so the spans of every session are in the trace
+	traceSession trace(tracePath);
 
+	if (store.load() == false)
+	{
+		std::cout << "ERROR: File handling\n";
+		return 1;
+	}
+
+	if (batchPath != "")
+	{
+		bool batched = runBatch(store, batchPath, batchResultPath);
+		return saveMetrics(metricsPath) && batched ? 0 : 1;
+	}
+
+	if (lookupId != 0)
+	{
+		savingAccount idSaving;
+		checkingAccount idChecking;
+		if (store.findSavingById(lookupId, idSaving))
+		{
+			std::cout << "Saving account\n\n";
+			idSaving.printInfo();
+		}
+		else if (store.findCheckingById(lookupId, idChecking))
+		{
+			std::cout << "Checking account\n\n";
+			idChecking.printInfo();
+		}
+		else
+		{
+			std::cout << "No account with ID " << lookupId << "\n";
+			return 1;
+		}
+		return 0;
+	}
+
+	if (statementId != 0 || statements)
+	{
+		int64_t from = 0, to = 0;
+		if (parseStatementDate(statementFrom, false, from) == false || parseStatementDate(statementTo, true, to) == false)
+		{
+			std::cout << "Dates must be written as YYYY-MM-DD\n";
+			return 1;
+		}
+		if (statements)
+		{
+			size_t written = 0;
+			if (writeStatements(store, from, to, statementDirectory, statementThreads, written) == false)
+			{
+				std::cout << "ERROR: File handling\n";
+				return 1;
+			}
+			std::cout << "Wrote " << written << " statements to " << statementDirectory << "\n";
+			return 0;
+		}
+		if (writeStatement(store, statementId, from, to, std::cout) == false)
+		{
+			// The statement may have been started before its history failed to read
+			savingAccount idSaving;
+			checkingAccount idChecking;
+			if (store.findSavingById(statementId, idSaving) || store.findCheckingById(statementId, idChecking))
+			{
+				std::cout << "ERROR: File handling\n";
+			}
+			else
+			{
+				std::cout << "No account with ID " << statementId << "\n";
+			}
+			return 1;
+		}
+		return 0;
+	}
+
+	if (report)
+	{
+		accountTable table;
+		store.fillTable(table);
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		accountReport totals = table.report();
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		printReport(totals);
+		std::cout << "\nAggregated " << table.getaccountCount() << " accounts in " << elapsed.count() << " ms\n";
+		return 0;
+	}
+
+	if (postInterest)
+	{
+		size_t paid = 0;
+		if (store.postInterest(interestThreads, paid) == false)
+		{
+			std::cout << "ERROR: File handling\n";
+			return 1;
+		}
+		std::cout << "Posted accrued interest on " << paid << " saving accounts\n";
+		return 0;
+	}
+
+	if (serve)
+	{
+		bool served = runServer(store, serverPort);
+		return saveMetrics(metricsPath) && served ? 0 : 1;
+	}
+
+	terminalScreen screen;
 	do
 	{
 		if (currentlyLogged == false)
@@ -89,40 +352,46 @@ int main()
 			switch (navigator)
 			{
 			case 1:
-				currentlyLogged = login(user, userData, userAccountData, userChecking, userSaving);
+				currentlyLogged = login(user, store, userChecking, userSaving);
 				break;
 			case 2:
-				signUp(userData);
+				signUp(store);
 				break;
 			case 3:
 				exit = true;
 				break;
+			case 9:
+				displayMetrics();
+				break;
 			}
 		}
 		else if (currentlyLogged == true)
 		{
-			navigator = options(user);
+			navigator = options(*user);
 			switch (navigator)
 			{
 			case 1:
-				createAccount(user, userChecking, userSaving, userAccountData);
+				createAccount(user, userChecking, userSaving, store);
 				break;
 			case 2:
 				displayAccount(userChecking, userSaving);
 				break;
 			case 3:
-				withdrawAccount(user, userChecking, userSaving, userData);
+				withdrawAccount(userChecking, userSaving, store);
 				break;
 			case 4:
-				depositAccount(user, userChecking, userSaving, userData);
+				depositAccount(userChecking, userSaving, store);
 				break;
 			case 5:
 				currentlyLogged = logout(user, userChecking, userSaving);
 				break;
+			case 9:
+				displayMetrics();
+				break;
 			}
 		}
 	} while (exit == false);
-	return 0;
+	return saveMetrics(metricsPath) ? 0 : 1;
 }
 
 #pragma region Functions: Not logged in 
@@ -130,30 +399,25 @@ int welcome()
 {
 	/*
 		Asks the user for a number from 1-3 in a while loop.
-		Uses stringstream to validate that the input is an integer,
+		Reads a single keypress with readMenuKey and checks that it is a digit,
 		If it is, break the loop and return the integer.
 
 		Note: checking if the valid integer is 1, 2, or 3 is not required because
 		the welcome function will loop again if the navigator variable does not
 		lead to a function in the switch case statement.
+		9 is also accepted without being listed, and shows the operation latencies.
 	*/
 
 	int tempNav;
 	while (true)
 	{
-		std::string input;
-		std::stringstream ss;
-
-		system("cls");
+		clearScreen();
 		std::cout << "Welcome to the Project Bank\n\n";
 		std::cout << "[1] Login\n";
 		std::cout << "[2] Create Profile\n";
 		std::cout << "[3] Exit Program\n\n";
 		std::cout << "Select: ";
-		getline(std::cin, input);
-		ss << input;
-
-		if (ss >> tempNav)
+		if (readMenuKey(tempNav))
 		{
 			break;
 		}
@@ -161,56 +425,55 @@ int welcome()
 	return tempNav;
 }
 
-bool login(customer& _user, std::fstream& _userData, std::fstream& _userAccountData, checkingAccount& _userChecking, savingAccount& _userSaving)
+bool login(customerHandle& _user, accountStore& _store, checkingAccount& _userChecking, savingAccount& _userSaving)
 {
 	/*
 		Asks the user for a username and password.
 
-		Calls loadUser which checks if the inputs match records.
-			if there's a match, return true and load user data
-				call loadAccounts to load user account data if found
-					if a saving account is loaded, pay interest
+		Calls loadLogin which checks if the inputs match records.
+			if there's a match, return true and load the user data and user account data found with it
+				the saving balance already includes the interest accrued since it was last written, so nothing is saved
 			if there's no match, return false
 
 		Function returns true or false depending on whether user data was loaded or not
 
 		Parameters:
-			_user: Passed by reference to allow loading user data
-			_userData: (File streams must be passed by ref)
-			_userAccountData: (File streams must be passed by ref)
+			_user: Passed by reference to allow pointing it at the stored profile
+			_store: Passed by reference to allow looking up and updating stored data
 			_userChecking: Passed by reference to allow loading user account data
 			_userSaving: Passed by reference to allow loading user account data
 	*/
 
 	std::string usernameInput, passwordInput;
 	bool loginSuccess = false;
+	loginRecord login;
 
-	system("cls");
+	clearScreen();
 	std::cout << "Username: ";
 	getline(std::cin, usernameInput);
 	std::cout << "password: ";
 	getline(std::cin, passwordInput);
 
-	loginSuccess = loadUser(_user, _userData, passwordInput, usernameInput);
+	loginSuccess = loadLogin(login, _store, passwordInput, usernameInput);
 
 	if (loginSuccess == true)
 	{
-		loadAccounts(_user, _userChecking, _userSaving, _userAccountData);
-		if (_userSaving.getid() != 0.0)
-		{
-			_userSaving.payInterest();
-			updateSavingAccount(_user, _userSaving, _userAccountData);
-		}
+		std::cout << "\nSuccesfully logged in\n\n";
+		pauseScreen();
+
+		_user = login.user;
+		_userChecking = login.checking;
+		_userSaving = login.saving;
 	}
 	else if (loginSuccess == false)
 	{
 		std::cout << "\nLogin failed\n\n";
-		system("pause");
+		pauseScreen();
 	}
 	return loginSuccess;
 }
 
-void signUp(std::fstream& _userData)
+void signUp(accountStore& _store)
 {
 	/*
 		Asks the user to enter general information in a loop until the information is not blank
@@ -218,10 +481,10 @@ void signUp(std::fstream& _userData)
 		Calls userExistance to check if the username input already belongs to a profile
 			if it does, return true
 			else false
-		Loads profile into userData.txt if userExistance returns false
+		Stores the profile and appends it to userData.txt if userExistance returns false
 
 		Parameters:
-			_userData: (File streams must be passed by ref) Stores created profile data into _userData file stream.
+			_store: Passed by reference to allow storing created profile data
 	*/
 
 	std::string firstName, lastName, address, phoneNum, password, email, usernameInput;
@@ -229,7 +492,7 @@ void signUp(std::fstream& _userData)
 
 	do
 	{
-		system("cls");
+		clearScreen();
 		if (emptyField == true)
 		{
 			std::cout << "Fields cannot be blank\n\n";
@@ -264,51 +527,45 @@ void signUp(std::fstream& _userData)
 		password = inputPasswd(validPasswd);
 	} while (validPasswd == false);
 
-	userExists = userExistance(_userData, usernameInput);
+	userExists = userExistance(_store, usernameInput);
 
 	if (userExists == false)
 	{
-		_userData.open("userData.txt", std::ios::app);
-
-		_userData << usernameInput;
-		_userData << ":" << firstName;
-		_userData << ":" << lastName;
-		_userData << ":" << address;
-		_userData << ":" << phoneNum;
-		_userData << ":" << email;
-		_userData << ":" << password << ":\n";
-
-		_userData.close();
-		std::cout << "User profile created\n\n";
+		if (_store.addUser(customer(firstName, lastName, address, phoneNum, email, usernameInput), password) == nullptr)
+		{
+			std::cout << "ERROR: File handling\n";
+		}
+		else
+		{
+			std::cout << "User profile created\n\n";
+		}
 	}
 	else
 	{
 		std::cout << "Profile already exists\n\n";
 	}
-	system("pause");
+	pauseScreen();
 }
 #pragma endregion
 
 #pragma region Functions: Logged in
-int options(customer _user)
+int options(const customer& _user)
 {
 	/*
 		Asks the user for a number from 1-5 in a while loop.
-		Uses stringstream to validate that the input is an integer,
+		Reads a single keypress with readMenuKey and checks that it is a digit,
 		If it is, break the loop and return the integer.
 
 		Note: checking if the valid integer is 1-5 is not required because
 		the options function will loop again if the navigator variable does not
 		lead to a function in the switch case statement.
+		9 is also accepted without being listed, and shows the operation latencies.
 	*/
 
 	int tempNav;
 	while (true)
 	{
-		std::string input;
-		std::stringstream ss;
-
-		system("cls");
+		clearScreen();
 		std::cout << "Welcome " << _user.getfirstName() << "\n\n";
 		std::cout << "[1] Create checking or saving account\n";
 		std::cout << "[2] Display an account\n";
@@ -316,10 +573,7 @@ int options(customer _user)
 		std::cout << "[4] Deposit to account\n";
 		std::cout << "[5] Logout\n\n";
 		std::cout << "Select: ";
-		getline(std::cin, input);
-		ss << input;
-
-		if (ss >> tempNav)
+		if (readMenuKey(tempNav))
 		{
 			break;
 		}
@@ -327,13 +581,13 @@ int options(customer _user)
 	return tempNav;
 }
 
-void createAccount(customer _user, checkingAccount& _userChecking, savingAccount& _userSaving, std::fstream& _userAccountData)
+void createAccount(const customerHandle& _user, checkingAccount& _userChecking, savingAccount& _userSaving, accountStore& _store)
 {
 	/*
 		checks for existance of accounts and returns true/false to corresponding variables
 
 		Asks the user for a number from 1-3 in a while loop.
-		Uses stringstream to validate that the input is an integer,
+		Reads a single keypress with readMenuKey and checks that it is a digit,
 		If it is, break the loop.
 
 		Note: checking if the valid integer is 1-3 is not required because
@@ -350,8 +604,8 @@ void createAccount(customer _user, checkingAccount& _userChecking, savingAccount
 			Exits function by breaking do while loop
 
 		Parameters:
-			_user: for reading user data
-			_userAccountData: (File streams must be passed by ref) for storing created account data
+			_user: handle attached to the created account
+			_store: Passed by reference for storing created account data
 			_userChecking: Passed by reference to allow creating user account data
 			_userSaving: Passed by reference to allow creating user account data
 	*/
@@ -359,24 +613,19 @@ void createAccount(customer _user, checkingAccount& _userChecking, savingAccount
 	int tempNav;
 	bool tempExit = false, savingExists = false, checkingExists = false;
 
-	savingExists = savingExistance(_userAccountData, _user);
-	checkingExists = checkingExistance(_userAccountData, _user);
+	savingExists = savingExistance(_store, *_user);
+	checkingExists = checkingExistance(_store, *_user);
 
 	do
 	{
 		while (true)
 		{
-			std::string input;
-			std::stringstream ss;
-			system("cls");
+			clearScreen();
 			std::cout << "[1] Create checking account\n";
 			std::cout << "[2] Create saving account\n";
 			std::cout << "[3] Cancel\n\n";
 			std::cout << "Select: ";
-			getline(std::cin, input);
-			ss << input;
-
-			if (ss >> tempNav)
+			if (readMenuKey(tempNav))
 			{
 				break;
 			}
@@ -387,33 +636,37 @@ void createAccount(customer _user, checkingAccount& _userChecking, savingAccount
 		case 1:
 			if (checkingExists == false)
 			{
-				system("cls");
-				createChecking(_userAccountData, _user, _userChecking);
-				std::cout << "Checking account created\n\n";
-				tempExit = true;
+				clearScreen();
+				if (createChecking(_store, _user, _store.allocateId(), _userChecking))
+				{
+					std::cout << "Checking account created\n\n";
+					tempExit = true;
+				}
 			}
 			else
 			{
-				system("cls");
+				clearScreen();
 				std::cout << "Checking account already created\n\n";
 			}
-			system("pause");
+			pauseScreen();
 			break;
 
 		case 2:
 			if (savingExists == false)
 			{
-				system("cls");
-				createSaving(_userAccountData, _user, _userSaving);
-				std::cout << "Saving account created\n\n";
-				tempExit = true;
+				clearScreen();
+				if (createSaving(_store, _user, _store.allocateId(), _userSaving))
+				{
+					std::cout << "Saving account created\n\n";
+					tempExit = true;
+				}
 			}
 			else
 			{
-				system("cls");
+				clearScreen();
 				std::cout << "Saving account already created\n\n";
 			}
-			system("pause");
+			pauseScreen();
 			break;
 
 		case 3:
@@ -423,11 +676,11 @@ void createAccount(customer _user, checkingAccount& _userChecking, savingAccount
 	} while (tempExit == false);
 }
 
-void displayAccount(checkingAccount _userChecking, savingAccount _userSaving)
+void displayAccount(const checkingAccount& _userChecking, const savingAccount& _userSaving)
 {
 	/*
 		Asks the user for a number from 1-3 in a while loop.
-		Uses stringstream to validate that the input is an integer,
+		Reads a single keypress with readMenuKey and checks that it is a digit,
 		If it is, break the loop.
 
 		Note: checking if the valid integer is 1-3 is not required because
@@ -444,8 +697,8 @@ void displayAccount(checkingAccount _userChecking, savingAccount _userSaving)
 			Exits function by breaking do while loop
 
 		Parameters:
-			_userChecking: Passed by value since data is only being read/output
-			_userSaving: Passed by value since data is only being read/output
+			_userChecking: Passed by const reference since data is only being read/output
+			_userSaving: Passed by const reference since data is only being read/output
 	*/
 
 	int tempNav;
@@ -455,17 +708,12 @@ void displayAccount(checkingAccount _userChecking, savingAccount _userSaving)
 	{
 		while (true)
 		{
-			std::string input;
-			std::stringstream ss;
-			system("cls");
+			clearScreen();
 			std::cout << "[1] Display checking account\n";
 			std::cout << "[2] Display saving account\n";
 			std::cout << "[3] Cancel\n\n";
 			std::cout << "Select: ";
-			getline(std::cin, input);
-			ss << input;
-
-			if (ss >> tempNav)
+			if (readMenuKey(tempNav))
 			{
 				break;
 			}
@@ -476,31 +724,31 @@ void displayAccount(checkingAccount _userChecking, savingAccount _userSaving)
 		case 1:
 			if (_userChecking.getid() == 0)
 			{
-				system("cls");
+				clearScreen();
 				std::cout << "No checking account found\n\n";
 			}
 			else
 			{
-				system("cls");
+				clearScreen();
 				_userChecking.printInfo();
 				tempExit = true;
 			}
-			system("pause");
+			pauseScreen();
 			break;
 
 		case 2:
 			if (_userSaving.getid() == 0)
 			{
-				system("cls");
+				clearScreen();
 				std::cout << "No saving account found\n\n";
 			}
 			else
 			{
-				system("cls");
+				clearScreen();
 				_userSaving.printInfo();
 				tempExit = true;
 			}
-			system("pause");
+			pauseScreen();
 			break;
 
 		case 3:
@@ -510,11 +758,11 @@ void displayAccount(checkingAccount _userChecking, savingAccount _userSaving)
 	} while (tempExit == false);
 }
 
-void withdrawAccount(customer _user, checkingAccount& _userChecking, savingAccount& _userSaving, std::fstream& _userAccountData)
+void withdrawAccount(checkingAccount& _userChecking, savingAccount& _userSaving, accountStore& _store)
 {
 	/*
 		Asks the user for a number from 1-3 in a while loop.
-		Uses stringstream to validate that the input is an integer,
+		Reads a single keypress with readMenuKey and checks that it is a digit,
 		If it is, break the loop.
 
 		Note: checking if the valid integer is 1-3 is not required because
@@ -522,7 +770,10 @@ void withdrawAccount(customer _user, checkingAccount& _userChecking, savingAccou
 		lead to a valid switch case statement.
 
 		If the user inputs 1 or 2 (indicating they would like to make a withdrawal),
-		ask the user for a float and validate it is a float using a stringstream
+		ask the user for an amount and validate it is dollars and cents using parseMoney
+
+		The balance rules are applied by checkingAccount::applyWithdrawal and savingAccount::applyWithdrawal,
+		which the batch processor shares.
 
 		Case 1:
 			If checking exists and is loaded
@@ -546,8 +797,7 @@ void withdrawAccount(customer _user, checkingAccount& _userChecking, savingAccou
 			Exits function by breaking do while loop
 
 		Parameters:
-			_user: Passed by value since data from _user is not being modified
-			_userAccountData: (File streams must be passed by ref) for modifying stored account data
+			_store: Passed by reference for modifying stored account data
 			_userChecking: Passed by reference to allow modifying user account data
 			_userSaving: Passed by reference to allow modifying user account data
 	*/
@@ -557,20 +807,15 @@ void withdrawAccount(customer _user, checkingAccount& _userChecking, savingAccou
 
 	do
 	{
-		float withAmount = 0;
+		money withAmount;
 		while (true)
 		{
-			std::string input;
-			std::stringstream ss;
-			system("cls");
+			clearScreen();
 			std::cout << "[1] Withdraw from checking account\n";
 			std::cout << "[2] Withdraw from saving account\n";
 			std::cout << "[3] Cancel\n\n";
 			std::cout << "Select: ";
-			getline(std::cin, input);
-			ss << input;
-
-			if (ss >> tempNav)
+			if (readMenuKey(tempNav))
 			{
 				break;
 			}
@@ -579,13 +824,11 @@ void withdrawAccount(customer _user, checkingAccount& _userChecking, savingAccou
 		while (tempNav == 1 || tempNav == 2)
 		{
 			std::string input;
-			std::stringstream ss;
-			system("cls");
+			clearScreen();
 			std::cout << "Enter withdrawal amount: ";
 			getline(std::cin, input);
-			ss << input;
 
-			if (ss >> withAmount)
+			if (parseMoney(input, withAmount))
 			{
 				break;
 			}
@@ -596,74 +839,73 @@ void withdrawAccount(customer _user, checkingAccount& _userChecking, savingAccou
 		case 1:
 			if (_userChecking.getid() == 0)
 			{
-				system("cls");
+				clearScreen();
 				std::cout << "No checking account found\n\n";
 			}
 			else
 			{
-				if ((_userChecking.getbalance() - withAmount) >= 0 && (withAmount > 0))
+				withdrawalResult result = _userChecking.applyWithdrawal(withAmount);
+				clearScreen();
+				if (result == WITHDRAWN)
 				{
-					_userChecking.withdrawal(withAmount);
-					system("cls");
-					updateCheckingAccount(_user, _userChecking, _userAccountData);
-					std::cout << "Successful withdrawal of " << withAmount << "\n";
-					std::cout << "New balance:  " << _userChecking.getbalance() << "\n\n";
+					if (updateCheckingAccount(_userChecking, _store))
+					{
+						std::cout << "Successful withdrawal of " << withAmount << "\n";
+						std::cout << "New balance:  " << _userChecking.getbalance() << "\n\n";
+					}
 					tempExit = true;
 				}
-				else if ((_userChecking.getbalance() - withAmount) >= (0 - _userChecking.getoverdraftLimit()) && (withAmount > 0))
+				else if (result == WITHDRAWN_WITH_FEE)
 				{
-					system("cls");
-					_userChecking.withdrawal(withAmount);;
-					_userChecking.setbalance(_userChecking.getbalance() - 5);
-					updateCheckingAccount(_user, _userChecking, _userAccountData);
-					std::cout << "Successful withdrawal of " << withAmount << "\n";
-					std::cout << "Service fee of $5 charged" << "\n";
-					std::cout << "New balance:  " << _userChecking.getbalance() << "\n\n";
+					if (updateCheckingAccount(_userChecking, _store))
+					{
+						std::cout << "Successful withdrawal of " << withAmount << "\n";
+						std::cout << "Service fee of $" << checkingAccount::overdraftFee << " charged" << "\n";
+						std::cout << "New balance:  " << _userChecking.getbalance() << "\n\n";
+					}
 					tempExit = true;
 				}
-				else if (withAmount <= 0)
+				else if (result == INVALID_AMOUNT)
 				{
-					system("cls");
 					std::cout << "Withdrawal must be greater than 0$\n\n";
 				}
 				else
 				{
-					system("cls");
 					std::cout << "Insufficient Balance\n";
 				}
 			}
-			system("pause");
+			pauseScreen();
 			break;
 
 		case 2:
 			if (_userSaving.getid() == 0)
 			{
-				system("cls");
+				clearScreen();
 				std::cout << "No saving account found\n\n";
 			}
 			else
 			{
-				if ((_userSaving.getbalance() - withAmount) >= 0 && (withAmount > 0))
+				withdrawalResult result = _userSaving.applyWithdrawal(withAmount);
+				clearScreen();
+				if (result == WITHDRAWN)
 				{
-					_userSaving.withdrawal(withAmount);
-					system("cls");
-					updateSavingAccount(_user, _userSaving, _userAccountData);
-					std::cout << "Successful withdrawal of " << withAmount << "\n";
-					std::cout << "New balance:  " << _userSaving.getbalance() << "\n\n";
+					if (updateSavingAccount(_userSaving, _store))
+					{
+						std::cout << "Successful withdrawal of " << withAmount << "\n";
+						std::cout << "New balance:  " << _userSaving.getbalance() << "\n\n";
+					}
 					tempExit = true;
 				}
-				else if (withAmount <= 0)
+				else if (result == INVALID_AMOUNT)
 				{
-					system("cls");
 					std::cout << "Withdrawal must be greater than 0$\n\n";
 				}
 				else
 				{
-					system("cls");
 					std::cout << "Insufficient Balance\n\n";
 				}
 			}
-			system("pause");
+			pauseScreen();
 			break;
 
 		case 3:
@@ -673,11 +915,11 @@ void withdrawAccount(customer _user, checkingAccount& _userChecking, savingAccou
 	} while (tempExit == false);
 }
 
-void depositAccount(customer _user, checkingAccount& _userChecking, savingAccount& _userSaving, std::fstream& _userAccountData)
+void depositAccount(checkingAccount& _userChecking, savingAccount& _userSaving, accountStore& _store)
 {
 	/*
 		Asks the user for a number from 1-3 in a while loop.
-		Uses stringstream to validate that the input is an integer,
+		Reads a single keypress with readMenuKey and checks that it is a digit,
 		If it is, break the loop.
 
 		Note: checking if the valid integer is 1-3 is not required because
@@ -685,7 +927,7 @@ void depositAccount(customer _user, checkingAccount& _userChecking, savingAccoun
 		lead to a valid switch case statement.
 
 		If the user inputs 1 or 2 (indicating they would like to make a deposit),
-		ask the user for a float and validate it is a float using a stringstream
+		ask the user for an amount and validate it is dollars and cents using parseMoney
 
 		Case 1:
 			If checking exists and is loaded
@@ -703,8 +945,7 @@ void depositAccount(customer _user, checkingAccount& _userChecking, savingAccoun
 			Exits function by breaking do while loop
 
 		Parameters:
-			_user: Passed by value since data from _user is not being modified
-			_userAccountData: (File streams must be passed by ref) for modifying stored account data
+			_store: Passed by reference for modifying stored account data
 			_userChecking: Passed by reference to allow modifying user account data
 			_userSaving: Passed by reference to allow modifying user account data
 	*/
@@ -714,20 +955,15 @@ void depositAccount(customer _user, checkingAccount& _userChecking, savingAccoun
 
 	do
 	{
-		float depAmount = 0;
+		money depAmount;
 		while (true)
 		{
-			std::string input;
-			std::stringstream ss;
-			system("cls");
+			clearScreen();
 			std::cout << "[1] Deposit into checking account\n";
 			std::cout << "[2] Deposit into saving accoun\n";
 			std::cout << "[3] Cancel\n\n";
 			std::cout << "Select: ";
-			getline(std::cin, input);
-			ss << input;
-
-			if (ss >> tempNav)
+			if (readMenuKey(tempNav))
 			{
 				break;
 			}
@@ -736,13 +972,11 @@ void depositAccount(customer _user, checkingAccount& _userChecking, savingAccoun
 		while (tempNav == 1 || tempNav == 2)
 		{
 			std::string input;
-			std::stringstream ss;
-			system("cls");
+			clearScreen();
 			std::cout << "Enter deposit amount: ";
 			getline(std::cin, input);
-			ss << input;
 
-			if (ss >> depAmount)
+			if (parseMoney(input, depAmount))
 			{
 				break;
 			}
@@ -753,53 +987,57 @@ void depositAccount(customer _user, checkingAccount& _userChecking, savingAccoun
 		case 1:
 			if (_userChecking.getid() == 0)
 			{
-				system("cls");
+				clearScreen();
 				std::cout << "No checking account found\n\n";
 			}
 			else
 			{
-				if (depAmount > 0)
+				if (depAmount > money())
 				{
 					_userChecking.deposit(depAmount);
-					system("cls");
-					updateCheckingAccount(_user, _userChecking, _userAccountData);
-					std::cout << "Successful deposit of " << depAmount << "\n";
-					std::cout << "New balance:  " << _userChecking.getbalance() << "\n\n";
+					clearScreen();
+					if (updateCheckingAccount(_userChecking, _store))
+					{
+						std::cout << "Successful deposit of " << depAmount << "\n";
+						std::cout << "New balance:  " << _userChecking.getbalance() << "\n\n";
+					}
 					tempExit = true;
 				}
 				else
 				{
-					system("cls");
+					clearScreen();
 					std::cout << "Must deposit greater than $0\n\n";
 				}
 			}
-			system("pause");
+			pauseScreen();
 			break;
 
 		case 2:
 			if (_userSaving.getid() == 0)
 			{
-				system("cls");
+				clearScreen();
 				std::cout << "No saving account found\n\n";
 			}
 			else
 			{
-				if (depAmount > 0)
+				if (depAmount > money())
 				{
 					_userSaving.deposit(depAmount);
-					system("cls");
-					updateSavingAccount(_user, _userSaving, _userAccountData);
-					std::cout << "Successful deposit of " << depAmount << "\n";
-					std::cout << "New balance:  " << _userSaving.getbalance() << "\n\n";
+					clearScreen();
+					if (updateSavingAccount(_userSaving, _store))
+					{
+						std::cout << "Successful deposit of " << depAmount << "\n";
+						std::cout << "New balance:  " << _userSaving.getbalance() << "\n\n";
+					}
 					tempExit = true;
 				}
 				else
 				{
-					system("cls");
+					clearScreen();
 					std::cout << "Must deposit greater than $0\n\n";
 				}
 			}
-			system("pause");
+			pauseScreen();
 			break;
 
 		case 3:
@@ -809,34 +1047,29 @@ void depositAccount(customer _user, checkingAccount& _userChecking, savingAccoun
 	} while (tempExit == false);
 }
 
-bool logout(customer& _user, checkingAccount& _userChecking, savingAccount& _userSaving)
+bool logout(customerHandle& _user, checkingAccount& _userChecking, savingAccount& _userSaving)
 {
 	/*
 		Clears _user, _userChecking, and _userSaving and returns true
 
 		Parameters:
-			_user: Passed by reference to allow modifying user data
+			_user: Passed by reference to allow releasing the profile handle
 			_userChecking: Passed by reference to allow modifying user account data
 			_userSaving: Passed by reference to allow modifying user account data
 	*/
 
-	_user.setusername("");
-	_user.setfirstName("");
-	_user.setlastName("");
-	_user.setaddress("");
-	_user.setphoneNum("");
-	_user.setemail("");
+	_user.reset();
 
-	_userChecking.setaccountCustomer(customer());
-	_userChecking.setbalance(0.0);
-	_userChecking.setoverdraftLimit(0.0);
+	_userChecking.setaccountCustomer(nullptr);
+	_userChecking.setbalance(money());
+	_userChecking.setoverdraftLimit(money());
 	_userChecking.setid(0);
 	_userChecking.setdepositCount(0);
 	_userChecking.setwithdrawalCount(0);
 
-	_userSaving.setaccountCustomer(customer());
-	_userSaving.setbalance(0.0);
-	_userSaving.setinterestRate(0.0);
+	_userSaving.setaccountCustomer(nullptr);
+	_userSaving.setbalance(money());
+	_userSaving.setinterestRate(fixedRate());
 	_userSaving.setid(0);
 	_userSaving.setdepositCount(0);
 	_userSaving.setwithdrawalCount(0);
@@ -845,142 +1078,37 @@ bool logout(customer& _user, checkingAccount& _userChecking, savingAccount& _use
 #pragma endregion
 
 #pragma region otherFunctions
-bool loadUser(customer& _user, std::fstream& _userData, std::string _passwordInput, std::string _usernameInput)
+void displayMetrics()
 {
 	/*
-		Called from login()
+		Called from main() when 9 is selected from either menu; the selection is not listed
 
-		Searchs userData.txt for a user with a username and password that matches input passed by value from login()
-
-		By default, the program returns false.
-		The function returns true and user data is loaded if a match is found.
+		Prints the count, mean and latency percentiles of every timed banking operation
+		since the program started
 	*/
 
-	bool loginSuccess = false;
-
-	_userData.open("userData.txt", std::ios::in);
-	std::string line;
-	while (std::getline(_userData, line))
-	{
-		std::stringstream ss(line);
-		std::string firstName, lastName, address, phoneNum, email, password, username;
-
-		std::getline(ss, username, ':');
-		std::getline(ss, firstName, ':');
-		std::getline(ss, lastName, ':');
-		std::getline(ss, address, ':');
-		std::getline(ss, phoneNum, ':');
-		std::getline(ss, email, ':');
-		std::getline(ss, password, ':');
-
-		if ((_usernameInput == username) && (_passwordInput == password) && (_usernameInput != "") && (_passwordInput != ""))
-		{
-			_user.setusername(username);
-			_user.setfirstName(firstName);
-			_user.setlastName(lastName);
-			_user.setaddress(address);
-			_user.setphoneNum(phoneNum);
-			_user.setemail(email);
-
-			std::cout << std::endl << "Succesfully logged in\n\n";
-			loginSuccess = true;
-			system("pause");
-			break;
-		}
-	}
-	_userData.close();
-	return loginSuccess;
+	clearScreen();
+	printOperationMetrics(std::cout);
+	std::cout << "\n";
+	pauseScreen();
 }
 
-void loadAccounts(customer _user, checkingAccount& _userChecking, savingAccount& _userSaving, std::fstream& _userAccountData)
+bool saveMetrics(const std::string& _metricsPath)
 {
 	/*
-		Called from login()
+		Called from main() before the program exits
 
-		Searchs userAccountData.txt for accounts with a matching username to the loaded user and loads those accounts
+		Writes the table displayMetrics prints to _metricsPath, if one was given with --metrics-file
 
-		When matches are found they are checked to see if they are saving or checking accounts,
-		then the data is converted from how it was read (strings) to the correct data type using string streams
-		finally the data is loaded into either _userSaving or _userChecking respectively.
+		returns false if the file could not be written
 	*/
 
-	_userAccountData.open("userAccountData.txt", std::ios::in);
-	std::string line;
-	while (std::getline(_userAccountData, line))
+	if (_metricsPath != "" && writeOperationMetrics(_metricsPath) == false)
 	{
-		std::stringstream ss(line);
-		std::string accountType;
-		std::string usernameAccount;
-
-		std::getline(ss, accountType, ':');
-		std::getline(ss, usernameAccount, ':');
-
-		if ((_user.getusername() == usernameAccount) && (accountType == "Saving"))
-		{
-			std::string balanceString, interestRateString, idString, depositCountString, withdrawalCountString;
-			float balance, interestRate;
-			int id, depositCount, withdrawalCount;
-
-			std::getline(ss, balanceString, ':');
-			std::getline(ss, interestRateString, ':');
-			std::getline(ss, idString, ':');
-			std::getline(ss, depositCountString, ':');
-			std::getline(ss, withdrawalCountString, ':');
-
-			std::stringstream balanceConv, interestRateConv, idConv, DepositCountConv, WithdrawalCountConv;
-
-			balanceConv << balanceString;
-			balanceConv >> balance;
-			interestRateConv << interestRateString;
-			interestRateConv >> interestRate;
-			idConv << idString;
-			idConv >> id;
-			DepositCountConv << depositCountString;
-			DepositCountConv >> depositCount;
-			WithdrawalCountConv << withdrawalCountString;
-			WithdrawalCountConv >> withdrawalCount;
-
-			_userSaving.setaccountCustomer(_user);
-			_userSaving.setbalance(balance);
-			_userSaving.setinterestRate(interestRate);
-			_userSaving.setid(id);
-			_userSaving.setdepositCount(depositCount);
-			_userSaving.setwithdrawalCount(withdrawalCount);
-		}
-		else if ((_user.getusername() == usernameAccount) && (accountType == "Checking"))
-		{
-			std::string balanceString, overdraftLimitString, idString, depositCountString, withdrawalCountString;
-			float balance, overdraftLimit;
-			int id, depositCount, withdrawalCount;
-
-			std::getline(ss, balanceString, ':');
-			std::getline(ss, overdraftLimitString, ':');
-			std::getline(ss, idString, ':');
-			std::getline(ss, depositCountString, ':');
-			std::getline(ss, withdrawalCountString, ':');
-
-			std::stringstream balanceConv, overdraftLimitConv, idConv, DepositCountConv, WithdrawalCountConv;
-
-			balanceConv << balanceString;
-			balanceConv >> balance;
-			overdraftLimitConv << overdraftLimitString;
-			overdraftLimitConv >> overdraftLimit;
-			idConv << idString;
-			idConv >> id;
-			DepositCountConv << depositCountString;
-			DepositCountConv >> depositCount;
-			WithdrawalCountConv << withdrawalCountString;
-			WithdrawalCountConv >> withdrawalCount;
-
-			_userChecking.setaccountCustomer(_user);
-			_userChecking.setbalance(balance);
-			_userChecking.setoverdraftLimit(overdraftLimit);
-			_userChecking.setid(id);
-			_userChecking.setdepositCount(depositCount);
-			_userChecking.setwithdrawalCount(withdrawalCount);
-		}
+		std::cout << "ERROR: File handling\n";
+		return false;
 	}
-	_userAccountData.close();
+	return true;
 }
 
 std::string inputPasswd(bool& _valid)
@@ -1001,7 +1129,7 @@ std::string inputPasswd(bool& _valid)
 	std::string password, password2;
 	bool hasUpper = false, hasSpecial = false, hasLower = false, hasNum = false, hasEight = false, match = false;
 
-	system("cls");
+	clearScreen();
 	std::cout << "Create password \n";
 	std::cout << "Minimum of 8 characters\n";
 	std::cout << "At least one uppercase letter\n";
@@ -1041,7 +1169,7 @@ std::string inputPasswd(bool& _valid)
 		}
 	}
 
-	std::cout << std::endl;
+	std::cout << "\n";
 	if (match == false)
 	{
 		std::cout << "Passwords do not match\n";
@@ -1071,7 +1199,7 @@ std::string inputPasswd(bool& _valid)
 	if (hasEight == false || hasUpper == false || hasLower == false || hasNum == false || hasSpecial == false || match == false)
 	{
 		std::cout << "\n";
-		system("pause");
+		pauseScreen();
 	}
 
 	if (hasEight == true && hasUpper == true && hasLower == true && hasNum == true && hasSpecial == true && match == true)
@@ -1080,345 +1208,4 @@ std::string inputPasswd(bool& _valid)
 	}
 	return password;
 }
-
-bool userExistance(std::fstream& _userData, std::string _usernameInput)
-{
-	/*
-		Called by singUp()
-
-		Checks userData.txt for a username matching the input username
-
-		sets userExists to true if a match is found (false is the default)
-
-		returns userExists
-	*/
-
-	bool userExists = false;
-
-	_userData.open("userData.txt", std::ios::in);
-	std::string line;
-	while (std::getline(_userData, line))
-	{
-		std::stringstream ss(line);
-		std::string username;
-
-		std::getline(ss, username, ':');
-		if (_usernameInput == username)
-		{
-			userExists = true;
-			break;
-		}
-	}
-	_userData.close();
-	return userExists;
-}
-
-bool savingExistance(std::fstream& _userAccountData, customer _user)
-{
-	/*
-		Called by createAccount()
-
-		Checks userAccountData.txt for a saving account with the loaded _user username
-
-		sets exists to true if a match is found (false is the default)
-
-		returns exists
-	*/
-
-	bool exists = false;
-
-	_userAccountData.open("userAccountData.txt", std::ios::in);
-	std::string line;
-	while (std::getline(_userAccountData, line))
-	{
-		std::stringstream ss(line);
-		std::string accountType;
-		std::string usernameAccount;
-
-		std::getline(ss, accountType, ':');
-		std::getline(ss, usernameAccount, ':');
-		if ((_user.getusername() == usernameAccount) && (accountType == "Saving"))
-		{
-			exists = true;
-		}
-	}
-	_userAccountData.close();
-
-	return exists;
-}
-
-bool checkingExistance(std::fstream& _userAccountData, customer _user)
-{
-	/*
-		Called by createAccount()
-
-		Checks userAccountData.txt for a checking account with the loaded _user username
-
-		sets exists to true if a match is found (false is the default)
-
-		returns exists
-	*/
-
-	bool exists = false;
-
-	_userAccountData.open("userAccountData.txt", std::ios::in);
-	std::string line;
-	while (std::getline(_userAccountData, line))
-	{
-		std::stringstream ss(line);
-		std::string accountType;
-		std::string usernameAccount;
-
-		std::getline(ss, accountType, ':');
-		std::getline(ss, usernameAccount, ':');
-		if ((_user.getusername() == usernameAccount) && (accountType == "Checking"))
-		{
-			exists = true;
-		}
-	}
-	_userAccountData.close();
-
-	return exists;
-}
-
-void createSaving(std::fstream& _userAccountData, customer _user, savingAccount& _userSaving)
-{
-	/*
-		Called by createAccount()
-
-		uses mersenne twister random algorithm with a random device generated seed to generate a random id number between 100000 to 999999
-
-		sets account values with default values and random ID
-
-		stores account into userAccoundData.txt
-	*/
-
-	std::mt19937 rndEngine{ std::random_device{}() };
-	std::uniform_int_distribution<> uniformDist(100000, 999999);
-	int id = uniformDist(rndEngine);
-
-	_userSaving.setaccountCustomer(_user);
-	_userSaving.setbalance(0);
-	_userSaving.setinterestRate(.05);
-	_userSaving.setid(id);
-	_userSaving.setdepositCount(0);
-	_userSaving.setwithdrawalCount(0);
-
-	_userAccountData.open("userAccountData.txt", std::ios::app);
-	_userAccountData << "Saving";
-	_userAccountData << ":" << _user.getusername();
-	_userAccountData << ":" << 0;
-	_userAccountData << ":" << .05;
-	_userAccountData << ":" << id;
-	_userAccountData << ":" << 0;
-	_userAccountData << ":" << 0 << ":\n";
-	_userAccountData.close();
-}
-
-void createChecking(std::fstream& _userAccountData, customer _user, checkingAccount& _userChecking)
-{
-	/*
-		Called by createAccount()
-
-		uses mersenne twister random algorithm with a random device generated seed to generate a random id number between 100000 to 999999
-
-		sets account values with default values and random ID
-
-		stores account into userAccoundData.txt
-	*/
-
-	std::mt19937 rndEngine{ std::random_device{}() };
-	std::uniform_int_distribution<> uniformDist(100000, 999999);
-	int id = uniformDist(rndEngine);
-
-	_userChecking.setaccountCustomer(_user);
-	_userChecking.setbalance(0);
-	_userChecking.setoverdraftLimit(25);
-	_userChecking.setid(id);
-	_userChecking.setdepositCount(0);
-	_userChecking.setwithdrawalCount(0);
-
-	_userAccountData.open("userAccountData.txt", std::ios::app);
-	_userAccountData << "Checking";
-	_userAccountData << ":" << _user.getusername();
-	_userAccountData << ":" << 0;
-	_userAccountData << ":" << 25;
-	_userAccountData << ":" << id;
-	_userAccountData << ":" << 0;
-	_userAccountData << ":" << 0 << ":\n";
-	_userAccountData.close();
-}
-
-void updateSavingAccount(customer _user, savingAccount _userSaving, std::fstream& _userAccountData)
-{
-	/*
-		Opens userAccountData.txt and newUserAccountData.txt
-		Writes data from userAccountData.txt to newUserAccountData.txt
-		if the line being read from userAccountData.txt contains the saving account data of the current user
-			don't write it to newUserAccountData.txt
-			write the data from the loaded saving account to newUserAccountData.txt instead
-		Closes both text files
-		deletes userAccountData.txt
-		renames newUserAccountData.txt to userAccountData.txt
-
-	*/
-
-	std::fstream newUserAccountData;
-	newUserAccountData.open("newUserAccountData.txt", std::ios::out);
-
-	_userAccountData.open("userAccountData.txt", std::ios::in);
-	std::string line;
-	while (std::getline(_userAccountData, line))
-	{
-		std::stringstream ss(line);
-		std::string accountType;
-		std::string usernameAccount;
-
-		std::getline(ss, accountType, ':');
-		std::getline(ss, usernameAccount, ':');
-		if ((_user.getusername() == usernameAccount) && ("Saving" == accountType))
-		{
-			newUserAccountData << "Saving";
-			newUserAccountData << ":" << _user.getusername();
-			newUserAccountData << ":" << _userSaving.getbalance();
-			newUserAccountData << ":" << _userSaving.getinterestRate();
-			newUserAccountData << ":" << _userSaving.getid();
-			newUserAccountData << ":" << _userSaving.getdepositCount();
-			newUserAccountData << ":" << _userSaving.getwithdrawalCount() << ":\n";
-		}
-		else
-		{
-			if (accountType == "Saving")
-			{
-				std::string balance, interestRate, id, depositCount, withdrawalCount;
-
-				std::getline(ss, balance, ':');
-				std::getline(ss, interestRate, ':');
-				std::getline(ss, id, ':');
-				std::getline(ss, depositCount, ':');
-				std::getline(ss, withdrawalCount, ':');
-
-				newUserAccountData << "Saving";
-				newUserAccountData << ":" << usernameAccount;
-				newUserAccountData << ":" << balance;
-				newUserAccountData << ":" << interestRate;
-				newUserAccountData << ":" << id;
-				newUserAccountData << ":" << depositCount;
-				newUserAccountData << ":" << withdrawalCount << ":\n";
-			}
-			else if (accountType == "Checking")
-			{
-				std::string balance, overdraftLimit, id, depositCount, withdrawalCount;
-
-				std::getline(ss, balance, ':');
-				std::getline(ss, overdraftLimit, ':');
-				std::getline(ss, id, ':');
-				std::getline(ss, depositCount, ':');
-				std::getline(ss, withdrawalCount, ':');
-
-				newUserAccountData << "Checking";
-				newUserAccountData << ":" << usernameAccount;
-				newUserAccountData << ":" << balance;
-				newUserAccountData << ":" << overdraftLimit;
-				newUserAccountData << ":" << id;
-				newUserAccountData << ":" << depositCount;
-				newUserAccountData << ":" << withdrawalCount << ":\n";
-			}
-		}
-	}
-	_userAccountData.close();
-	newUserAccountData.close();
-	std::remove("userAccountData.txt");
-	if (rename("newUserAccountData.txt", "userAccountData.txt") != 0)
-	{
-		std::cout << "ERROR: File handling\n";
-		system("pause");
-	}
-}
-
-void updateCheckingAccount(customer _user, checkingAccount _userChecking, std::fstream& _userAccountData)
-{
-	/*
-		Opens userAccountData.txt and newUserAccountData.txt
-		Writes data from userAccountData.txt to newUserAccountData.txt
-		if the line being read from userAccountData.txt contains the checking account data of the current user
-			don't write it to newUserAccountData.txt
-			write the data from the loaded checking account to newUserAccountData.txt instead
-		Closes both text files
-		deletes userAccountData.txt
-		renames newUserAccountData.txt to userAccountData.txt
-	*/
-
-	std::fstream newUserAccountData;
-	newUserAccountData.open("newUserAccountData.txt", std::ios::out);
-
-	_userAccountData.open("userAccountData.txt", std::ios::in);
-	std::string line;
-	while (std::getline(_userAccountData, line))
-	{
-		std::stringstream ss(line);
-		std::string accountType;
-		std::string usernameAccount;
-
-		std::getline(ss, accountType, ':');
-		std::getline(ss, usernameAccount, ':');
-		if ((_user.getusername() == usernameAccount) && ("Checking" == accountType))
-		{
-			newUserAccountData << "Checking";
-			newUserAccountData << ":" << _user.getusername();
-			newUserAccountData << ":" << _userChecking.getbalance();
-			newUserAccountData << ":" << _userChecking.getoverdraftLimit();
-			newUserAccountData << ":" << _userChecking.getid();
-			newUserAccountData << ":" << _userChecking.getdepositCount();
-			newUserAccountData << ":" << _userChecking.getwithdrawalCount() << ":\n";
-		}
-		else
-		{
-			if (accountType == "Saving")
-			{
-				std::string balance, interestRate, id, depositCount, withdrawalCount;
-
-				std::getline(ss, balance, ':');
-				std::getline(ss, interestRate, ':');
-				std::getline(ss, id, ':');
-				std::getline(ss, depositCount, ':');
-				std::getline(ss, withdrawalCount, ':');
-
-				newUserAccountData << "Saving";
-				newUserAccountData << ":" << usernameAccount;
-				newUserAccountData << ":" << balance;
-				newUserAccountData << ":" << interestRate;
-				newUserAccountData << ":" << id;
-				newUserAccountData << ":" << depositCount;
-				newUserAccountData << ":" << withdrawalCount << ":\n";
-			}
-			else if (accountType == "Checking")
-			{
-				std::string balance, overdraftLimit, id, depositCount, withdrawalCount;
-
-				std::getline(ss, balance, ':');
-				std::getline(ss, overdraftLimit, ':');
-				std::getline(ss, id, ':');
-				std::getline(ss, depositCount, ':');
-				std::getline(ss, withdrawalCount, ':');
-
-				newUserAccountData << "Checking";
-				newUserAccountData << ":" << usernameAccount;
-				newUserAccountData << ":" << balance;
-				newUserAccountData << ":" << overdraftLimit;
-				newUserAccountData << ":" << id;
-				newUserAccountData << ":" << depositCount;
-				newUserAccountData << ":" << withdrawalCount << ":\n";
-			}
-		}
-	}
-	_userAccountData.close();
-	newUserAccountData.close();
-	std::remove("userAccountData.txt");
-	if (rename("newUserAccountData.txt", "userAccountData.txt") != 0)
-	{
-		std::cout << "ERROR: File handling\n";
-		system("pause");
-	}
-}
 #pragma endregion
\ No newline at end of file
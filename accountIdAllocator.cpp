@@ -0,0 +1,241 @@
+#include "accountIdAllocator.h"
+#include <random>
+
+#ifdef _WIN32
+#include <intrin.h>
+#endif
+
+namespace
+{
+	const size_t wordBits = 64;
+
+	// idLimit function returns the first id wider than _width digits
+	int64_t idLimit(int _width)
+	{
+		int64_t limit = 1;
+		for (int digit = 0; digit < _width; digit++)
+		{
+			limit *= 10;
+		}
+		return limit;
+	}
+
+	// lowestBit function returns the index of the lowest set bit of a non zero word
+	size_t lowestBit(uint64_t _word)
+	{
+#ifdef _WIN32
+		unsigned long index;
+		_BitScanForward64(&index, _word);
+		return index;
+#else
+		return static_cast<size_t>(__builtin_ctzll(_word));
+#endif
+	}
+}
+
+#pragma region Account Id Allocator Class Implementation
+// Constructors, used for account id allocator creation
+// The random device is read once here instead of once per account
+accountIdAllocator::accountIdAllocator()
+{
+	width = firstWidth;
+	capacity = static_cast<size_t>(idLimit(width) - firstId);
+	bits.assign((capacity + wordBits - 1) / wordBits, 0);
+	usedCount = 0;
+	std::mt19937 rndEngine{ std::random_device{}() };
+	cursor = std::uniform_int_distribution<size_t>(0, capacity - 1)(rndEngine);
+}
+
+// Ids
+
+// clear function frees every id and shrinks the range back to six digits, as before load()
+void accountIdAllocator::clear()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	width = firstWidth;
+	capacity = static_cast<size_t>(idLimit(width) - firstId);
+	bits.assign((capacity + wordBits - 1) / wordBits, 0);
+	bits.shrink_to_fit();
+	usedCount = 0;
+	cursor %= capacity;
+}
+
+// markUsed function records an id that is already taken, such as one read from the account files
+// Ids outside the range the allocator hands out are ignored, and the range is widened to cover a wider id
+void accountIdAllocator::markUsed(int _id)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	markUnlocked(_id);
+}
+
+bool accountIdAllocator::isUsed(int _id) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (_id < firstId || static_cast<size_t>(_id - firstId) >= capacity)
+	{
+		return false;
+	}
+	size_t index = static_cast<size_t>(_id - firstId);
+	return (bits[index / wordBits] >> (index % wordBits) & 1) != 0;
+}
+
+// allocate function returns an unused id and marks it as used, or 0 if every id up to maxWidth digits is taken
+int accountIdAllocator::allocate()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return next();
+}
+
+// lease function takes up to _count unused ids into _ids under one lock, returning how many it took
+size_t accountIdAllocator::lease(int* _ids, size_t _count)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	size_t leased = 0;
+	for (; leased < _count; leased++)
+	{
+		int id = next();
+		if (id == 0)
+		{
+			break;
+		}
+		_ids[leased] = id;
+	}
+	return leased;
+}
+
+// release function frees leased ids that were never given to an account
+void accountIdAllocator::release(const int* _ids, size_t _count)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for (size_t i = 0; i < _count; i++)
+	{
+		if (_ids[i] < firstId || static_cast<size_t>(_ids[i] - firstId) >= capacity)
+		{
+			continue;
+		}
+		size_t index = static_cast<size_t>(_ids[i] - firstId);
+		uint64_t bit = uint64_t(1) << (index % wordBits);
+		if ((bits[index / wordBits] & bit) != 0)
+		{
+			bits[index / wordBits] &= ~bit;
+			usedCount--;
+		}
+	}
+}
+
+// markUnlocked function sets the id's bit, returning false if the id is out of range or was already used
+bool accountIdAllocator::markUnlocked(int _id)
+{
+	if (_id < firstId || _id >= idLimit(maxWidth))
+	{
+		return false;
+	}
+	while (_id >= idLimit(width))
+	{
+		widen(width + 1);
+	}
+
+	size_t index = static_cast<size_t>(_id - firstId);
+	uint64_t bit = uint64_t(1) << (index % wordBits);
+	if ((bits[index / wordBits] & bit) != 0)
+	{
+		return false;
+	}
+	bits[index / wordBits] |= bit;
+	usedCount++;
+	return true;
+}
+
+// widen function grows the range to _width digit ids, returning false past maxWidth
+bool accountIdAllocator::widen(int _width)
+{
+	if (_width > maxWidth)
+	{
+		return false;
+	}
+	width = _width;
+	capacity = static_cast<size_t>(idLimit(width) - firstId);
+	bits.resize((capacity + wordBits - 1) / wordBits, 0);
+	return true;
+}
+
+// next function finds the first unused id at or after the cursor, wrapping around once, and widens the range when it is full
+int accountIdAllocator::next()
+{
+	if (usedCount == capacity)
+	{
+		size_t previousCapacity = capacity;
+		if (widen(width + 1) == false)
+		{
+			return 0;
+		}
+		// Start handing out the new, wider ids
+		cursor = previousCapacity;
+	}
+
+	size_t words = bits.size();
+	size_t word = cursor / wordBits;
+	uint64_t freeBits = ~bits[word] & (~uint64_t(0) << (cursor % wordBits));
+	for (size_t step = 0; step <= words; step++)
+	{
+		if (freeBits != 0)
+		{
+			size_t index = word * wordBits + lowestBit(freeBits);
+			// The last word can have bits past the end of the range
+			if (index < capacity)
+			{
+				bits[word] |= uint64_t(1) << (index % wordBits);
+				usedCount++;
+				cursor = index + 1 == capacity ? 0 : index + 1;
+				return static_cast<int>(firstId + index);
+			}
+		}
+		word = word + 1 == words ? 0 : word + 1;
+		freeBits = ~bits[word];
+	}
+	return 0;
+}
+
+// Getters, used for returning private attributes
+int accountIdAllocator::getwidth() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return width;
+}
+
+size_t accountIdAllocator::getusedCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return usedCount;
+}
+#pragma endregion
+
+#pragma region Id Lease Class Implementation
+// Constructors, used for id lease creation
+// No ids are leased until the first call to next()
+idLease::idLease(accountIdAllocator& _allocator) : allocator(_allocator)
+{
+	count = 0;
+	taken = 0;
+}
+
+idLease::~idLease()
+{
+	allocator.release(ids + taken, count - taken);
+}
+
+// next function returns the next leased id, leasing another block when the current one is used up, or 0 if none are left
+int idLease::next()
+{
+	if (taken == count)
+	{
+		count = allocator.lease(ids, blockSize);
+		taken = 0;
+		if (count == 0)
+		{
+			return 0;
+		}
+	}
+	return ids[taken++];
+}
+#pragma endregion
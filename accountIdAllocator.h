@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// AccountIdAllocator class declaration
+//
+// Hands out account ids that are never already in use. Every id from firstId up to the end of the current width
+// has one bit in a bitmap, so checking an id is a single bit test and load() marks each existing account's id.
+// New ids are taken from a cursor that starts at a random place in the range and walks forward a word at a time,
+// so ids stay spread out the way the old random ids were without ever colliding.
+//
+// Ids start six digits wide. When every six digit id is taken the range grows to seven digits, and so on up to
+// maxWidth, which still fits the 32 bit id field of the account files. allocate() returns 0 once every id is taken.
+//
+// The allocator can be shared by several threads. A session that creates many accounts can lease a block of ids
+// with one call instead of taking the lock for every id; leased ids are marked as used until they are released.
+class accountIdAllocator
+{
+public:
+	// Constructors
+	accountIdAllocator();
+
+	// Ids
+	void clear();
+	void markUsed(int _id);
+	bool isUsed(int _id) const;
+	int allocate();
+	size_t lease(int* _ids, size_t _count);
+	void release(const int* _ids, size_t _count);
+
+	// Getters
+	int getwidth() const;
+	size_t getusedCount() const;
+
+	static const int firstId = 100000;
+	static const int firstWidth = 6;
+	static const int maxWidth = 9;
+
+private:
+	bool markUnlocked(int _id);
+	bool widen(int _width);
+	int next();
+
+	// Attributes
+	std::vector<uint64_t> bits;
+	size_t capacity;
+	size_t usedCount;
+	size_t cursor;
+	int width;
+	mutable std::mutex mutex;
+};
+
+// IdLease class declaration
+//
+// A block of ids leased from an accountIdAllocator for one session. next() takes ids from the block without locking
+// and leases another block when it runs out; the ids the session never used are released when the lease is destroyed.
+class idLease
+{
+public:
+	// Constructors
+	idLease(accountIdAllocator& _allocator);
+	~idLease();
+	idLease(const idLease&) = delete;
+	idLease& operator=(const idLease&) = delete;
+
+	// Ids
+	int next();
+
+	static const size_t blockSize = 16;
+
+private:
+	// Attributes
+	accountIdAllocator& allocator;
+	int ids[blockSize];
+	size_t count;
+	size_t taken;
+};
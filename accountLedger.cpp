@@ -0,0 +1,689 @@
+#include "accountLedger.h"
+#include "durableFile.h"
+#include "traceLog.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+	const char fileMagic[4] = { 'C', 'B', 'L', 'G' };
+	const char blockMagic[4] = { 'B', 'L', 'K', '1' };
+	const uint32_t fileVersion = 1;
+
+	// ledgerFileHeader: first bytes of the block file
+	struct ledgerFileHeader
+	{
+		char magic[4];
+		uint32_t version;
+	};
+
+	// ledgerBlockHeader: the fixed part in front of every block's columns
+	// openingBalance is the balance before the block's first entry and checksum covers the header and the columns
+	struct ledgerBlockHeader
+	{
+		char magic[4];
+		int32_t accountId;
+		uint32_t firstEntry;
+		uint32_t entries;
+		int64_t firstTimestamp;
+		int64_t lastTimestamp;
+		int64_t openingBalance;
+		uint32_t payloadBytes;
+		uint32_t checksum;
+	};
+
+	// ledgerJournalRow: one entry as it is appended to the journal
+	// entry is the entry's number in its account's history, so rows that are already sealed can be skipped on load
+	struct ledgerJournalRow
+	{
+		int32_t accountId;
+		uint32_t entry;
+		int64_t timestamp;
+		int64_t amount;
+		int64_t balance;
+		uint8_t type;
+		uint8_t reserved[7];
+	};
+
+	// zigzag function maps small negative and positive numbers to small unsigned numbers, so both encode in few bytes
+	uint64_t zigzag(int64_t _value)
+	{
+		return (static_cast<uint64_t>(_value) << 1) ^ static_cast<uint64_t>(_value >> 63);
+	}
+
+	int64_t unzigzag(uint64_t _value)
+	{
+		return static_cast<int64_t>(_value >> 1) ^ -static_cast<int64_t>(_value & 1);
+	}
+
+	// putVarint function appends _value seven bits at a time, with the high bit set on every byte but the last
+	void putVarint(std::string& _out, uint64_t _value)
+	{
+		while (_value >= 0x80)
+		{
+			_out.push_back(static_cast<char>((_value & 0x7F) | 0x80));
+			_value >>= 7;
+		}
+		_out.push_back(static_cast<char>(_value));
+	}
+
+	// getVarint function reads a value written by putVarint, returning false if it runs past _end
+	bool getVarint(const char*& _next, const char* _end, uint64_t& _value)
+	{
+		_value = 0;
+		for (int shift = 0; shift < 64 && _next < _end; shift += 7)
+		{
+			uint8_t byte = static_cast<uint8_t>(*_next++);
+			_value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// checksum function is 32 bit FNV-1a, enough to tell a whole block from one cut short by a crash
+	uint32_t checksum(const char* _data, size_t _length, uint32_t _hash = 2166136261u)
+	{
+		for (size_t i = 0; i < _length; i++)
+		{
+			_hash = (_hash ^ static_cast<uint8_t>(_data[i])) * 16777619u;
+		}
+		return _hash;
+	}
+
+	uint32_t blockChecksum(ledgerBlockHeader _header, const std::string& _payload)
+	{
+		_header.checksum = 0;
+		return checksum(_payload.data(), _payload.size(), checksum(reinterpret_cast<const char*>(&_header), sizeof(_header)));
+	}
+
+	// encodeBlock function writes _count entries into _payload column by column and fills in the block header
+	void encodeBlock(int _accountId, uint32_t _firstEntry, const ledgerEntry* _entries, uint32_t _count, ledgerBlockHeader& _header, std::string& _payload)
+	{
+		std::memcpy(_header.magic, blockMagic, sizeof(blockMagic));
+		_header.accountId = _accountId;
+		_header.firstEntry = _firstEntry;
+		_header.entries = _count;
+		_header.firstTimestamp = _entries[0].timestamp;
+		_header.lastTimestamp = _entries[_count - 1].timestamp;
+		_header.openingBalance = _entries[0].balance.getcents() - balanceChange(_entries[0]).getcents();
+
+		_payload.clear();
+		int64_t previous = _header.firstTimestamp;
+		for (uint32_t i = 0; i < _count; i++)
+		{
+			putVarint(_payload, zigzag(_entries[i].timestamp - previous));
+			previous = _entries[i].timestamp;
+		}
+		for (uint32_t i = 0; i < _count; i++)
+		{
+			_payload.push_back(static_cast<char>(_entries[i].type));
+		}
+		for (uint32_t i = 0; i < _count; i++)
+		{
+			putVarint(_payload, zigzag(_entries[i].amount.getcents()));
+		}
+		// Each balance is stored as its difference from the previous balance plus the entry's amount, nearly always 0
+		int64_t balance = _header.openingBalance;
+		for (uint32_t i = 0; i < _count; i++)
+		{
+			int64_t expected = balance + balanceChange(_entries[i]).getcents();
+			putVarint(_payload, zigzag(_entries[i].balance.getcents() - expected));
+			balance = _entries[i].balance.getcents();
+		}
+
+		_header.payloadBytes = static_cast<uint32_t>(_payload.size());
+		_header.checksum = blockChecksum(_header, _payload);
+	}
+
+	// decodeBlock function reads the entries of a block back into _entries, returning false if the columns are damaged
+	bool decodeBlock(const ledgerBlockHeader& _header, const std::string& _payload, std::vector<ledgerEntry>& _entries)
+	{
+		_entries.resize(_header.entries);
+		const char* next = _payload.data();
+		const char* end = next + _payload.size();
+		uint64_t value;
+
+		int64_t timestamp = _header.firstTimestamp;
+		for (ledgerEntry& entry : _entries)
+		{
+			if (getVarint(next, end, value) == false)
+			{
+				return false;
+			}
+			timestamp += unzigzag(value);
+			entry.timestamp = timestamp;
+		}
+		for (ledgerEntry& entry : _entries)
+		{
+			if (next == end || *next < LEDGER_DEPOSIT || *next > LEDGER_INTEREST)
+			{
+				return false;
+			}
+			entry.type = static_cast<ledgerEntryType>(*next++);
+		}
+		for (ledgerEntry& entry : _entries)
+		{
+			if (getVarint(next, end, value) == false)
+			{
+				return false;
+			}
+			entry.amount = money::fromCents(unzigzag(value));
+		}
+		int64_t balance = _header.openingBalance;
+		for (ledgerEntry& entry : _entries)
+		{
+			if (getVarint(next, end, value) == false)
+			{
+				return false;
+			}
+			balance += balanceChange(entry).getcents() + unzigzag(value);
+			entry.balance = money::fromCents(balance);
+		}
+		return next == end;
+	}
+
+	// makeRow function fills a journal row for entry number _entry of an account
+	ledgerJournalRow makeRow(int _accountId, uint32_t _entry, const ledgerEntry& _ledgerEntry)
+	{
+		ledgerJournalRow row;
+		std::memset(&row, 0, sizeof(row));
+		row.accountId = _accountId;
+		row.entry = _entry;
+		row.timestamp = _ledgerEntry.timestamp;
+		row.amount = _ledgerEntry.amount.getcents();
+		row.balance = _ledgerEntry.balance.getcents();
+		row.type = _ledgerEntry.type;
+		return row;
+	}
+
+	// readBlock function reads and decodes one sealed block, returning false if it could not be read
+	bool readBlock(std::istream& _in, const ledgerBlock& _block, std::vector<ledgerEntry>& _entries)
+	{
+		ledgerBlockHeader header;
+		std::string payload(_block.length - sizeof(header), '\0');
+		_in.seekg(static_cast<std::streamoff>(_block.offset));
+		return _in.read(reinterpret_cast<char*>(&header), sizeof(header)).good() && _in.read(&payload[0], payload.size()).good()
+			&& decodeBlock(header, payload, _entries);
+	}
+
+	// inRange function is true if the entry's time lies from _from up to and including _to
+	bool inRange(const ledgerEntry& _entry, int64_t _from, int64_t _to)
+	{
+		return _entry.timestamp >= _from && _entry.timestamp <= _to;
+	}
+}
+
+#pragma region Account Ledger Class Implementation
+// balanceChange function returns the entry's amount, negated for withdrawals and overdraft fees
+money balanceChange(const ledgerEntry& _entry)
+{
+	if (_entry.type == LEDGER_WITHDRAWAL || _entry.type == LEDGER_OVERDRAFT_FEE)
+	{
+		return -_entry.amount;
+	}
+	return _entry.amount;
+}
+
+
+// Constructors, used for account ledger creation
+accountLedger::accountLedger()
+{
+	path = "userLedger";
+	blocksEnd = 0;
+	journalEntries = 0;
+	tailEntries = 0;
+}
+
+// Setters, used for setting specific private attributes
+// The ledger's files are _path + ".blocks" and _path + ".journal"
+void accountLedger::setpath(std::string _path)
+{
+	path = std::move(_path);
+}
+
+// Opening
+
+// open function reads the block file's index and replays the journal on top, creating both files if they do not exist
+// A block or journal row cut short by a crash is dropped; its entries are still in the journal or were never recorded
+// Returns false if a file could not be opened or was not written by this version
+bool accountLedger::open()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (blocks.is_open())
+	{
+		blocks.close();
+	}
+	if (journal.is_open())
+	{
+		journal.close();
+	}
+	histories.clear();
+	journalEntries = 0;
+	tailEntries = 0;
+
+	if (std::ifstream(blocksPath()).good() == false)
+	{
+		std::ofstream created(blocksPath(), std::ios::out | std::ios::binary);
+		ledgerFileHeader header;
+		std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+		header.version = fileVersion;
+		created.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		if (created.good() == false)
+		{
+			return false;
+		}
+	}
+	blocks.open(blocksPath(), std::ios::in | std::ios::out | std::ios::binary);
+	if (blocks.is_open() == false || loadBlocks() == false)
+	{
+		return false;
+	}
+
+	bool rewrite = false;
+	if (loadJournal(rewrite) == false)
+	{
+		return false;
+	}
+	journal.open(journalPath(), std::ios::out | std::ios::app | std::ios::binary);
+	if (journal.is_open() == false)
+	{
+		return false;
+	}
+
+	// Entries that filled a block before a crash could seal them are sealed now
+	for (std::pair<const int, ledgerHistory>& history : histories)
+	{
+		while (history.second.tail.size() >= blockEntries)
+		{
+			if (seal(history.first, history.second) == false)
+			{
+				return false;
+			}
+		}
+	}
+	return rewrite ? compactJournal() : true;
+}
+
+// close function closes both files and forgets the index
+void accountLedger::close()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	blocks.close();
+	journal.close();
+	histories.clear();
+	journalEntries = 0;
+	tailEntries = 0;
+}
+
+// loadBlocks function reads every block header of the block file into the index, stopping at the first damaged block
+// so the next block is written over it
+bool accountLedger::loadBlocks()
+{
+	ledgerFileHeader fileHeader;
+	if (blocks.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader)).good() == false
+		|| std::memcmp(fileHeader.magic, fileMagic, sizeof(fileMagic)) != 0 || fileHeader.version != fileVersion)
+	{
+		return false;
+	}
+
+	blocksEnd = sizeof(fileHeader);
+	ledgerBlockHeader header;
+	std::string payload;
+	while (blocks.read(reinterpret_cast<char*>(&header), sizeof(header)).good())
+	{
+		if (std::memcmp(header.magic, blockMagic, sizeof(blockMagic)) != 0 || header.entries == 0 || header.entries > blockEntries)
+		{
+			break;
+		}
+		payload.resize(header.payloadBytes);
+		if (blocks.read(&payload[0], payload.size()).good() == false || blockChecksum(header, payload) != header.checksum)
+		{
+			break;
+		}
+
+		ledgerHistory& history = histories[header.accountId];
+		if (header.firstEntry == history.sealedEntries)
+		{
+			history.blocks.push_back(ledgerBlock{ blocksEnd, static_cast<uint32_t>(sizeof(header) + payload.size()), header.entries, header.firstTimestamp, header.lastTimestamp });
+			history.sealedEntries += header.entries;
+		}
+		blocksEnd += sizeof(header) + payload.size();
+	}
+	blocks.clear();
+	return true;
+}
+
+// loadJournal function appends every journal row that is not already in a block to its account's tail
+// Sets _rewrite if the journal ends in a partial row, which must not stay in front of the next row appended
+bool accountLedger::loadJournal(bool& _rewrite)
+{
+	std::ifstream in(journalPath(), std::ios::in | std::ios::binary);
+	if (in.is_open() == false)
+	{
+		return true;
+	}
+
+	ledgerJournalRow row;
+	while (in.read(reinterpret_cast<char*>(&row), sizeof(row)).good())
+	{
+		journalEntries++;
+		ledgerHistory& history = histories[row.accountId];
+		if (row.entry != history.sealedEntries + history.tail.size() || row.type < LEDGER_DEPOSIT || row.type > LEDGER_INTEREST)
+		{
+			continue;
+		}
+		history.tail.push_back(ledgerEntry{ row.timestamp, money::fromCents(row.amount), money::fromCents(row.balance), static_cast<ledgerEntryType>(row.type) });
+		tailEntries++;
+	}
+	_rewrite = in.gcount() != 0;
+	return true;
+}
+
+// Entries
+
+// record function adds an account's entries to its history, returning false if they could not be written
+// The entries are only flushed here; sync() makes them durable
+bool accountLedger::record(int _accountId, const std::vector<ledgerEntry>& _entries)
+{
+	if (_entries.empty())
+	{
+		return true;
+	}
+	traceSpan span("ledgerRecord", "io");
+	span.setargument("entries", static_cast<int64_t>(_entries.size()));
+	std::lock_guard<std::mutex> lock(mutex);
+	for (const ledgerEntry& entry : _entries)
+	{
+		append(_accountId, entry);
+	}
+	journal.flush();
+	if (journal.good() == false)
+	{
+		return false;
+	}
+
+	ledgerHistory& history = histories[_accountId];
+	if (history.tail.size() >= blockEntries && seal(_accountId, history) == false)
+	{
+		return false;
+	}
+	return compactIfDue();
+}
+
+// record function adds the entries of many accounts under one lock, as a job that changes every account does
+bool accountLedger::record(const std::vector<ledgerEvent>& _events)
+{
+	if (_events.empty())
+	{
+		return true;
+	}
+	traceSpan span("ledgerRecord", "io");
+	span.setargument("entries", static_cast<int64_t>(_events.size()));
+	std::lock_guard<std::mutex> lock(mutex);
+	for (const ledgerEvent& event : _events)
+	{
+		append(event.accountId, event.entry);
+	}
+	journal.flush();
+	if (journal.good() == false)
+	{
+		return false;
+	}
+
+	for (const ledgerEvent& event : _events)
+	{
+		ledgerHistory& history = histories[event.accountId];
+		if (history.tail.size() >= blockEntries && seal(event.accountId, history) == false)
+		{
+			return false;
+		}
+	}
+	return compactIfDue();
+}
+
+// append function writes one journal row and adds the entry to its account's tail, with the ledger lock held
+void accountLedger::append(int _accountId, const ledgerEntry& _entry)
+{
+	ledgerHistory& history = histories[_accountId];
+	ledgerJournalRow row = makeRow(_accountId, history.sealedEntries + static_cast<uint32_t>(history.tail.size()), _entry);
+	journal.write(reinterpret_cast<const char*>(&row), sizeof(row));
+	history.tail.push_back(_entry);
+	journalEntries++;
+	tailEntries++;
+}
+
+// seal function encodes the oldest blockEntries entries of an account's tail as one block at the end of the block file
+// Their journal rows stay until the journal is next compacted
+bool accountLedger::seal(int _accountId, ledgerHistory& _history)
+{
+	ledgerBlockHeader header;
+	std::string payload;
+	encodeBlock(_accountId, _history.sealedEntries, _history.tail.data(), blockEntries, header, payload);
+
+	blocks.seekp(static_cast<std::streamoff>(blocksEnd));
+	blocks.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	blocks.write(payload.data(), payload.size());
+	blocks.flush();
+	if (blocks.good() == false)
+	{
+		blocks.clear();
+		return false;
+	}
+
+	uint32_t length = static_cast<uint32_t>(sizeof(header) + payload.size());
+	_history.blocks.push_back(ledgerBlock{ blocksEnd, length, blockEntries, header.firstTimestamp, header.lastTimestamp });
+	_history.tail.erase(_history.tail.begin(), _history.tail.begin() + blockEntries);
+	_history.sealedEntries += blockEntries;
+	tailEntries -= blockEntries;
+	blocksEnd += length;
+	return true;
+}
+
+// scan function passes the account's entries from _from up to and including _to to _visit, oldest first,
+// until _visit returns false; only the blocks of that account that overlap the range are read
+// Returns false if a block could not be read
+bool accountLedger::scan(int _accountId, int64_t _from, int64_t _to, const std::function<bool(const ledgerEntry&)>& _visit) const
+{
+	std::vector<ledgerBlock> overlapping;
+	std::vector<ledgerEntry> tail;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		std::unordered_map<int, ledgerHistory>::const_iterator history = histories.find(_accountId);
+		if (history == histories.end())
+		{
+			return true;
+		}
+		for (const ledgerBlock& block : history->second.blocks)
+		{
+			if (block.lastTimestamp >= _from && block.firstTimestamp <= _to)
+			{
+				overlapping.push_back(block);
+			}
+		}
+		for (const ledgerEntry& entry : history->second.tail)
+		{
+			if (inRange(entry, _from, _to))
+			{
+				tail.push_back(entry);
+			}
+		}
+	}
+
+	if (overlapping.empty() == false)
+	{
+		// Sealed blocks are never written again, so they can be read without the lock
+		std::ifstream in(blocksPath(), std::ios::in | std::ios::binary);
+		std::vector<ledgerEntry> entries;
+		for (const ledgerBlock& block : overlapping)
+		{
+			if (readBlock(in, block, entries) == false)
+			{
+				return false;
+			}
+			for (const ledgerEntry& entry : entries)
+			{
+				if (inRange(entry, _from, _to) && _visit(entry) == false)
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	for (const ledgerEntry& entry : tail)
+	{
+		if (_visit(entry) == false)
+		{
+			return true;
+		}
+	}
+	return true;
+}
+
+// lastBefore function finds the account's last entry before _timestamp, such as the one holding a statement's opening
+// balance, decoding at most the one block it is in
+// Returns false if the account has no entry before _timestamp or its block could not be read
+bool accountLedger::lastBefore(int _accountId, int64_t _timestamp, ledgerEntry& _entry) const
+{
+	ledgerBlock block;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		std::unordered_map<int, ledgerHistory>::const_iterator history = histories.find(_accountId);
+		if (history == histories.end())
+		{
+			return false;
+		}
+		const std::vector<ledgerEntry>& tail = history->second.tail;
+		for (std::vector<ledgerEntry>::const_reverse_iterator entry = tail.rbegin(); entry != tail.rend(); entry++)
+		{
+			if (entry->timestamp < _timestamp)
+			{
+				_entry = *entry;
+				return true;
+			}
+		}
+		const std::vector<ledgerBlock>& blocks = history->second.blocks;
+		std::vector<ledgerBlock>::const_reverse_iterator found = std::find_if(blocks.rbegin(), blocks.rend(),
+			[_timestamp](const ledgerBlock& _block) { return _block.firstTimestamp < _timestamp; });
+		if (found == blocks.rend())
+		{
+			return false;
+		}
+		block = *found;
+	}
+
+	std::ifstream in(blocksPath(), std::ios::in | std::ios::binary);
+	std::vector<ledgerEntry> entries;
+	if (readBlock(in, block, entries) == false)
+	{
+		return false;
+	}
+	for (std::vector<ledgerEntry>::const_reverse_iterator entry = entries.rbegin(); entry != entries.rend(); entry++)
+	{
+		if (entry->timestamp < _timestamp)
+		{
+			_entry = *entry;
+			return true;
+		}
+	}
+	return false;
+}
+
+// sync function forces the journal onto disk, making every entry recorded so far durable
+// Blocks need no sync here, since their entries stay in the journal until compactJournal syncs the block file
+bool accountLedger::sync()
+{
+	return syncFile(journalPath());
+}
+
+// compactIfDue function compacts the journal once it holds journalCompactEntries rows and at least half are sealed
+bool accountLedger::compactIfDue()
+{
+	if (journalEntries < journalCompactEntries || journalEntries < tailEntries * 2)
+	{
+		return true;
+	}
+	return compactJournal();
+}
+
+// compactJournal function replaces the journal with one holding only the unsealed entries, with the ledger lock held
+// The block file is synced first, so the sealed entries are on disk before their rows are dropped
+bool accountLedger::compactJournal()
+{
+	traceSpan span("compactJournal", "io");
+	if (syncFile(blocksPath()) == false)
+	{
+		return false;
+	}
+
+	std::string newPath = journalPath() + ".new";
+	{
+		std::ofstream out(newPath, std::ios::out | std::ios::trunc | std::ios::binary);
+		for (const std::pair<const int, ledgerHistory>& history : histories)
+		{
+			uint32_t entry = history.second.sealedEntries;
+			for (const ledgerEntry& tailEntry : history.second.tail)
+			{
+				ledgerJournalRow row = makeRow(history.first, entry++, tailEntry);
+				out.write(reinterpret_cast<const char*>(&row), sizeof(row));
+			}
+		}
+		out.flush();
+		if (out.good() == false)
+		{
+			return false;
+		}
+	}
+	if (syncFile(newPath) == false)
+	{
+		return false;
+	}
+
+	journal.close();
+	bool replaced = replaceFile(newPath, journalPath()) && syncDirectory(journalPath());
+	journal.open(journalPath(), std::ios::out | std::ios::app | std::ios::binary);
+	if (replaced)
+	{
+		journalEntries = tailEntries;
+	}
+	return replaced && journal.is_open();
+}
+
+std::string accountLedger::blocksPath() const
+{
+	return path + ".blocks";
+}
+
+std::string accountLedger::journalPath() const
+{
+	return path + ".journal";
+}
+
+// Getters, used for returning private attributes
+size_t accountLedger::getentryCount(int _accountId) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	std::unordered_map<int, ledgerHistory>::const_iterator history = histories.find(_accountId);
+	if (history == histories.end())
+	{
+		return 0;
+	}
+	return history->second.sealedEntries + history->second.tail.size();
+}
+
+size_t accountLedger::getjournalEntries() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return journalEntries;
+}
+
+uint64_t accountLedger::getblockBytes() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return blocksEnd;
+}
+#pragma endregion
@@ -0,0 +1,106 @@
+#pragma once
+#include "userClasses.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ledgerEvent: a ledger entry together with the id of the account it belongs to
+struct ledgerEvent
+{
+	int accountId;
+	ledgerEntry entry;
+};
+
+// ledgerBlock: where one sealed block of an account's entries is kept in the block file
+struct ledgerBlock
+{
+	uint64_t offset;
+	uint32_t length;
+	uint32_t entries;
+	int64_t firstTimestamp;
+	int64_t lastTimestamp;
+};
+
+// ledgerHistory: the sealed blocks and the unsealed journal entries of one account
+// sealedEntries counts the entries in blocks, so the next entry's number is sealedEntries + tail.size()
+struct ledgerHistory
+{
+	std::vector<ledgerBlock> blocks;
+	std::vector<ledgerEntry> tail;
+	uint32_t sealedEntries;
+};
+
+// balanceChange function returns how much an entry changed its account's balance: negative for withdrawals and fees
+money balanceChange(const ledgerEntry& _entry);
+
+// AccountLedger class declaration
+//
+// Keeps the history of every account: each deposit, withdrawal, overdraft fee and interest payment with its time,
+// amount and resulting balance. The history is kept in two files next to each other:
+//   <path>.journal holds fixed-size rows for the newest entries of each account, appended as they happen
+//   <path>.blocks  holds sealed blocks of blockEntries entries of one account each
+// Once an account has blockEntries entries in the journal they are sealed into a block. A block stores its entries
+// column by column: timestamps as deltas from the previous entry, the entry types, the amounts, and the balances as the
+// difference from the previous balance plus or minus the amount, which is 0 unless the balance was changed some other
+// way. Every column is a run of variable-length integers, so a typical entry takes a few bytes instead of a 40 byte row.
+//
+// The ledger indexes every account's blocks by id, so scanning one account's history reads only that account's blocks,
+// and only those that overlap the requested time range. The journal is rewritten with just the unsealed entries once
+// it grows well past them; the block file is forced to disk first, so every entry is always in one file or the other.
+//
+// The ledger can be shared by several threads; recording and scanning take its lock only to update or copy the index.
+class accountLedger
+{
+public:
+	// Constructors
+	accountLedger();
+	accountLedger(const accountLedger&) = delete;
+	accountLedger& operator=(const accountLedger&) = delete;
+
+	// Setters
+	void setpath(std::string _path);
+
+	// Opening
+	bool open();
+	void close();
+
+	// Entries
+	bool record(int _accountId, const std::vector<ledgerEntry>& _entries);
+	bool record(const std::vector<ledgerEvent>& _events);
+	bool scan(int _accountId, int64_t _from, int64_t _to, const std::function<bool(const ledgerEntry&)>& _visit) const;
+	bool lastBefore(int _accountId, int64_t _timestamp, ledgerEntry& _entry) const;
+	bool sync();
+
+	// Getters
+	size_t getentryCount(int _accountId) const;
+	size_t getjournalEntries() const;
+	uint64_t getblockBytes() const;
+
+	static const uint32_t blockEntries = 32;
+	static const size_t journalCompactEntries = 65536;
+
+private:
+	void append(int _accountId, const ledgerEntry& _entry);
+	bool seal(int _accountId, ledgerHistory& _history);
+	bool loadBlocks();
+	bool loadJournal(bool& _rewrite);
+	bool compactJournal();
+	bool compactIfDue();
+	std::string blocksPath() const;
+	std::string journalPath() const;
+
+	// Attributes
+	std::string path;
+	std::unordered_map<int, ledgerHistory> histories;
+	std::fstream blocks;
+	uint64_t blocksEnd;
+	std::ofstream journal;
+	size_t journalEntries;
+	size_t tailEntries;
+	mutable std::mutex mutex;
+};
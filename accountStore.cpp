@@ -0,0 +1,1586 @@
+#include "accountStore.h"
+#include "recordParser.h"
+#include "durableFile.h"
+#include "operationMetrics.h"
+#include "traceLog.h"
+#include <fstream>
+#include <cstdio>
+#include <charconv>
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// Account lines parsed per span of the trace while loading
+	const size_t traceBatchLines = 65536;
+
+	// reusableRequest function returns the calling thread's request, emptied; pushing it leaves the buffers of an
+	// earlier request in it, so filling it again does not allocate
+	persistRequest& reusableRequest()
+	{
+		thread_local persistRequest request;
+		request.clear();
+		return request;
+	}
+
+	// sameAccountState function returns true if two copies of an account hold the same id, balance and counts
+	bool sameAccountState(const account& _first, const account& _second)
+	{
+		return _first.getid() == _second.getid() && _first.getbalance() == _second.getbalance()
+			&& _first.getdepositCount() == _second.getdepositCount() && _first.getwithdrawalCount() == _second.getwithdrawalCount();
+	}
+
+	// appendField functions append ':' and one field to an account line
+	void appendField(std::string& _line, const std::string& _text)
+	{
+		_line += ':';
+		_line += _text;
+	}
+
+	void appendField(std::string& _line, money _amount)
+	{
+		char text[formattedChars];
+		_line += ':';
+		_line.append(text, _amount.toChars(text, text + sizeof(text)));
+	}
+
+	void appendField(std::string& _line, fixedRate _rate)
+	{
+		char text[formattedChars];
+		_line += ':';
+		_line.append(text, _rate.toChars(text, text + sizeof(text)));
+	}
+
+	void appendField(std::string& _line, int64_t _number)
+	{
+		char digits[24];
+		_line += ':';
+		_line.append(digits, std::to_chars(digits, digits + sizeof(digits), _number).ptr);
+	}
+}
+
+#pragma region Account Store Class Implementation
+// Constructors, used for account store creation
+accountStore::accountStore()
+{
+	userDataPath = "userData.txt";
+	userAccountDataPath = "userAccountData.txt";
+	userAccountLogPath = "userAccountLog.txt";
+	logEntries = 0;
+	logGeneration = 0;
+	unsyncedUsers = false;
+	unsyncedLog = false;
+	unsyncedLedger = false;
+	compactThreshold = 10000;
+	batching = false;
+	snapshotRunning = false;
+	filterLookups = 0;
+	filterMisses = 0;
+	filterFalsePositives = 0;
+	committer.reset(new groupCommitter([this]() { return syncFiles(); }));
+}
+
+accountStore::accountStore(std::string _userDataPath, std::string _userAccountDataPath, std::string _userAccountLogPath)
+{
+	userDataPath = _userDataPath;
+	userAccountDataPath = _userAccountDataPath;
+	userAccountLogPath = _userAccountLogPath;
+	logEntries = 0;
+	logGeneration = 0;
+	unsyncedUsers = false;
+	unsyncedLog = false;
+	unsyncedLedger = false;
+	compactThreshold = 10000;
+	batching = false;
+	snapshotRunning = false;
+	filterLookups = 0;
+	filterMisses = 0;
+	filterFalsePositives = 0;
+	committer.reset(new groupCommitter([this]() { return syncFiles(); }));
+}
+
+// Destructor waits for a background snapshot to finish writing, and writes out changes still waiting in the queue,
+// such as the ledger entries of a batch that was never ended
+accountStore::~accountStore()
+{
+	if (snapshotThread.joinable())
+	{
+		snapshotThread.join();
+	}
+	if (submissions.getpendingCount() > 0)
+	{
+		committer->commit();
+	}
+}
+
+// Setters, used for setting specific private attributes
+void accountStore::setcompactThreshold(size_t _compactThreshold)
+{
+	compactThreshold = _compactThreshold;
+}
+
+// setcommitDelay function sets how long a group commit waits for more writes before its fsync
+void accountStore::setcommitDelay(std::chrono::microseconds _commitDelay)
+{
+	committer->setmaxDelay(_commitDelay);
+}
+
+// setbinaryPath function keeps accounts in a memory-mapped binaryAccountFile at the path instead of the text file and log
+// Each account remembers its slot, so an update is a single in-place store; load() creates the file from the text files
+void accountStore::setbinaryPath(std::string _binaryPath)
+{
+	binaryPath = _binaryPath;
+}
+
+// setledgerPath function sets where the ledger keeps its files, _ledgerPath + ".blocks" and _ledgerPath + ".journal"
+void accountStore::setledgerPath(std::string _ledgerPath)
+{
+	ledger.setpath(std::move(_ledgerPath));
+}
+
+// Loading
+
+// load function reads userData.txt and userAccountData.txt into memory, replacing anything already loaded,
+// then replays any sealed log segment the snapshot does not hold yet and userAccountLog.txt on top and opens the log
+// for appending
+// With a binary path set, accounts are read from the binary file instead and the text files are only used to create it
+// The ledger is opened too; returns false if the binary file or the ledger could not be created or opened
+bool accountStore::load()
+{
+	traceSpan span("load", "store");
+	if (ledger.open() == false)
+	{
+		return false;
+	}
+
+	bool snapshotDue = false;
+	{
+		std::unique_lock<std::shared_mutex> dataLock(dataMutex);
+		std::lock_guard<std::mutex> logLock(logMutex);
+		users.clear();
+		savings.clear();
+		checkings.clear();
+		savingSlots.clear();
+		checkingSlots.clear();
+
+		if (accountLog.is_open())
+		{
+			accountLog.close();
+		}
+
+		loadUsers();
+		if (binaryPath != "")
+		{
+			bool loaded = loadBinaryRecords();
+			indexAccounts();
+			startAccrual();
+			return loaded;
+		}
+
+		loadAccountRecords(userAccountDataPath);
+		// A sealed segment is only left behind when the last snapshot did not finish replacing userAccountData.txt,
+		// or when a crash came between the rename and the removal, in which case the snapshot already holds it
+		// A segment sealed before generations were kept has none and is always replayed, as it was then
+		uint64_t snapshotGeneration = readSnapshotGeneration(userAccountDataPath);
+		uint64_t sealedGeneration = readSealedGeneration(sealedLogPath());
+		logGeneration = std::max(snapshotGeneration, sealedGeneration);
+		size_t sealedEntries = 0;
+		if (sealedGeneration == 0 || sealedGeneration > snapshotGeneration)
+		{
+			sealedEntries = loadAccountRecords(sealedLogPath());
+		}
+		else if (std::remove(sealedLogPath().c_str()) == 0)
+		{
+			syncDirectory(sealedLogPath());
+		}
+		logEntries = loadAccountRecords(userAccountLogPath);
+		indexAccounts();
+		startAccrual();
+
+		accountLog.open(userAccountLogPath, std::ios::out | std::ios::app);
+		snapshotDue = sealedEntries > 0 || logEntries >= compactThreshold;
+	}
+	if (snapshotDue)
+	{
+		snapshot(true);
+	}
+	return true;
+}
+
+// loadUsers function reads every profile line of userData.txt into the users map
+void accountStore::loadUsers()
+{
+	traceSpan span("loadUsers", "parse");
+	recordReader userData;
+	{
+		traceSpan openSpan("open", "io");
+		userData.open(userDataPath);
+	}
+	std::string_view line;
+	while (userData.nextLine(line))
+	{
+		// username, first name, last name, address, phone number, email, password
+		std::string_view fields[7];
+		if (splitRecord(line, fields, 7) == 0 || fields[0].empty())
+		{
+			continue;
+		}
+
+		std::string username(fields[0]);
+		userRecord& record = users[username];
+		record.profile = std::make_shared<const customer>(std::string(fields[1]), std::string(fields[2]), std::string(fields[3]), std::string(fields[4]), std::string(fields[5]), username);
+		record.password = std::string(fields[6]);
+	}
+	userData.close();
+	span.setargument("users", static_cast<int64_t>(users.size()));
+
+	// Room to double the users before addUser has to rebuild the filter
+	rebuildUsernameFilter(users.size() * 2);
+	filterLookups = 0;
+	filterMisses = 0;
+	filterFalsePositives = 0;
+}
+
+// rebuildUsernameFilter function sizes the username filter for _capacity usernames and adds every loaded username,
+// with the data lock held exclusively
+void accountStore::rebuildUsernameFilter(size_t _capacity)
+{
+	usernameFilter.reset(std::max<size_t>(_capacity, 1024));
+	for (const std::pair<const std::string, userRecord>& user : users)
+	{
+		usernameFilter.add(user.first);
+	}
+}
+
+// loadAccountRecords function reads every account line of a file into the saving and checking maps and returns the line count
+// A later line for the same username and account type replaces an earlier one, which is how log entries are replayed
+// Must run after loadUsers so each account can be attached to its customer profile
+size_t accountStore::loadAccountRecords(const std::string& _path)
+{
+	traceSpan span("loadAccountRecords", "parse");
+	size_t records = 0;
+	recordReader userAccountData;
+	{
+		traceSpan openSpan("open", "io");
+		userAccountData.open(_path);
+	}
+	std::string_view line;
+	bool moreLines = true;
+	while (moreLines)
+	{
+		// Each batch of lines is one span of the trace, so a long file shows how parsing progressed through it
+		traceSpan batchSpan("parseRecords", "parse");
+		size_t batchLines = 0;
+		while (batchLines < traceBatchLines && (moreLines = userAccountData.nextLine(line)))
+		{
+			batchLines++;
+			accountLine account;
+			if (parseAccountLine(line, account) == false)
+			{
+				continue;
+			}
+
+			std::string usernameAccount(account.username);
+			if (account.type == "Saving")
+			{
+				savingAccount& saving = savings[usernameAccount];
+				saving = savingAccount(account.interestRate, accountCustomerFor(usernameAccount), account.balance, account.id, account.depositCount, account.withdrawalCount);
+				saving.setaccrualDay(account.accrualDay);
+			}
+			else if (account.type == "Checking")
+			{
+				checkings[usernameAccount] = checkingAccount(account.overdraftLimit, accountCustomerFor(usernameAccount), account.balance, account.id, account.depositCount, account.withdrawalCount);
+			}
+			records++;
+		}
+		batchSpan.setargument("lines", static_cast<int64_t>(batchLines));
+	}
+	userAccountData.close();
+	span.setargument("records", static_cast<int64_t>(records));
+	return records;
+}
+
+// loadBinaryRecords function maps the binary account file, converting the text file and log into it if it does not exist yet
+// or upgrading it if an older version wrote it, and reads every slot into the saving and checking maps
+bool accountStore::loadBinaryRecords()
+{
+	traceSpan span("loadBinaryRecords", "parse");
+	if (std::ifstream(binaryPath).good() == false)
+	{
+		if (binaryAccountFile::convertTextFile(userAccountDataPath, sealedLogPath(), userAccountLogPath, binaryPath) == false)
+		{
+			return false;
+		}
+	}
+	else if (binaryAccountFile::upgradeFile(binaryPath) == false)
+	{
+		return false;
+	}
+	if (binaryAccounts.open(binaryPath) == false)
+	{
+		return false;
+	}
+	// Slots are written back by the group commit instead of one page at a time
+	binaryAccounts.setsyncWrites(false);
+
+	for (size_t slot = 0; slot < binaryAccounts.getrecordCount(); slot++)
+	{
+		const binaryAccountRecord& record = binaryAccounts.getrecord(slot);
+		std::string usernameAccount = binaryAccountFile::getusername(record);
+		customerHandle accountCustomer = accountCustomerFor(usernameAccount);
+
+		if (record.type == 'S')
+		{
+			savingAccount& saving = savings[usernameAccount];
+			saving = savingAccount(fixedRate::fromMillionths(record.rate), accountCustomer, money::fromCents(record.balance), record.id, record.depositCount, record.withdrawalCount);
+			saving.setaccrualDay(record.accrualDay);
+			savingSlots[usernameAccount] = slot;
+		}
+		else if (record.type == 'C')
+		{
+			checkings[usernameAccount] = checkingAccount(money::fromCents(record.rate), accountCustomer, money::fromCents(record.balance), record.id, record.depositCount, record.withdrawalCount);
+			checkingSlots[usernameAccount] = slot;
+		}
+	}
+	span.setargument("records", static_cast<int64_t>(binaryAccounts.getrecordCount()));
+	return true;
+}
+
+// accountCustomerFor function returns the loaded profile for an account's username, or a new profile holding only the username
+customerHandle accountStore::accountCustomerFor(const std::string& _username) const
+{
+	std::unordered_map<std::string, userRecord>::const_iterator user = users.find(_username);
+	if (user != users.end())
+	{
+		return user->second.profile;
+	}
+
+	customer accountCustomer;
+	accountCustomer.setusername(_username);
+	return std::make_shared<const customer>(std::move(accountCustomer));
+}
+
+// startAccrual function starts interest from today for every saving account that has never accrued,
+// such as one written before accrual days were kept; the day is saved with the account's next write
+void accountStore::startAccrual()
+{
+	int64_t today = savingAccount::currentDay();
+	for (std::pair<const std::string, savingAccount>& account : savings)
+	{
+		if (account.second.getaccrualDay() == 0)
+		{
+			account.second.setaccrualDay(today);
+		}
+	}
+}
+
+// indexAccounts function rebuilds the id index from the loaded accounts and records every id as taken
+void accountStore::indexAccounts()
+{
+	accountIds.clear();
+	idIndex.clear();
+	idIndex.reserve(savings.size() + checkings.size());
+	for (std::pair<const std::string, userRecord>& user : users)
+	{
+		user.second.saving = nullptr;
+		user.second.checking = nullptr;
+	}
+	for (const std::pair<const std::string, savingAccount>& account : savings)
+	{
+		accountIds.markUsed(account.second.getid());
+		idIndex[account.second.getid()] = { 'S', &account.first };
+		linkSaving(account.first, &account.second);
+	}
+	for (const std::pair<const std::string, checkingAccount>& account : checkings)
+	{
+		accountIds.markUsed(account.second.getid());
+		idIndex[account.second.getid()] = { 'C', &account.first };
+		linkChecking(account.first, &account.second);
+	}
+}
+
+// linkSaving function points the username's user record at its saving account, if the user is loaded
+void accountStore::linkSaving(const std::string& _username, const savingAccount* _saving)
+{
+	std::unordered_map<std::string, userRecord>::iterator user = users.find(_username);
+	if (user != users.end())
+	{
+		user->second.saving = _saving;
+	}
+}
+
+// linkChecking function points the username's user record at its checking account, if the user is loaded
+void accountStore::linkChecking(const std::string& _username, const checkingAccount* _checking)
+{
+	std::unordered_map<std::string, userRecord>::iterator user = users.find(_username);
+	if (user != users.end())
+	{
+		user->second.checking = _checking;
+	}
+}
+
+// Users
+
+// userExists function returns true if a profile with the username is loaded
+// usernameFilter, a Bloom filter over every username built by load() and extended by addUser, answers for a username it
+// has never seen without probing the users map, as for most usernames checked when signing up
+bool accountStore::userExists(const std::string& _username) const
+{
+	std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+	filterLookups.fetch_add(1, std::memory_order_relaxed);
+	if (usernameFilter.mightContain(_username) == false)
+	{
+		filterMisses.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	if (users.find(_username) == users.end())
+	{
+		filterFalsePositives.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	return true;
+}
+
+// findUser function points _user at the profile and returns true if the username and password match a loaded profile
+bool accountStore::findUser(const std::string& _username, const std::string& _password, customerHandle& _user) const
+{
+	std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+	std::unordered_map<std::string, userRecord>::const_iterator user = users.find(_username);
+	if (user == users.end() || user->second.password != _password)
+	{
+		return false;
+	}
+	_user = user->second.profile;
+	return true;
+}
+
+// findLogin function fills _login with the profile and accounts of the user and returns true if the username and
+// password match a loaded profile
+// The user record points at both accounts, so the whole login is one users map lookup under one hold of the data lock
+// The credential check, the profile copy and the account copies are each timed as their own operation
+bool accountStore::findLogin(const std::string& _username, const std::string& _password, loginRecord& _login) const
+{
+	std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+	std::unordered_map<std::string, userRecord>::const_iterator user;
+	{
+		operationTimer timer(METRIC_LOGIN_CREDENTIALS);
+		user = users.find(_username);
+		if (user == users.end() || user->second.password != _password)
+		{
+			return false;
+		}
+	}
+	{
+		operationTimer timer(METRIC_LOGIN_PROFILE);
+		_login.user = user->second.profile;
+	}
+	operationTimer timer(METRIC_LOGIN_ACCOUNTS);
+	if (user->second.saving != nullptr)
+	{
+		_login.saving = *user->second.saving;
+		_login.saving.accrueInterest(savingAccount::currentDay());
+	}
+	else
+	{
+		_login.saving = savingAccount();
+	}
+	_login.checking = user->second.checking != nullptr ? *user->second.checking : checkingAccount();
+	return true;
+}
+
+// addUser function stores a new profile in memory, appends it to userData.txt and returns the stored profile once it is on disk
+// Returns nullptr if the profile could not be persisted
+customerHandle accountStore::addUser(customer _user, const std::string& _password)
+{
+	userRecord record;
+	record.profile = std::make_shared<const customer>(std::move(_user));
+	record.password = _password;
+	record.saving = nullptr;
+	record.checking = nullptr;
+	const customer& profile = *record.profile;
+
+	{
+		std::unique_lock<std::shared_mutex> dataLock(dataMutex);
+		if (users.find(profile.getusername()) == users.end())
+		{
+			if (usernameFilter.isFull())
+			{
+				rebuildUsernameFilter(users.size() * 2);
+			}
+			usernameFilter.add(profile.getusername());
+		}
+		users[profile.getusername()] = record;
+		persistRequest& request = reusableRequest();
+		request.userLine = profile.getusername();
+		appendField(request.userLine, profile.getfirstName());
+		appendField(request.userLine, profile.getlastName());
+		appendField(request.userLine, profile.getaddress());
+		appendField(request.userLine, profile.getphoneNum());
+		appendField(request.userLine, profile.getemail());
+		appendField(request.userLine, _password);
+		request.userLine += ":\n";
+		submissions.push(request);
+		std::unordered_map<std::string, savingAccount>::const_iterator saving = savings.find(profile.getusername());
+		if (saving != savings.end())
+		{
+			linkSaving(saving->first, &saving->second);
+		}
+		std::unordered_map<std::string, checkingAccount>::const_iterator checking = checkings.find(profile.getusername());
+		if (checking != checkings.end())
+		{
+			linkChecking(checking->first, &checking->second);
+		}
+	}
+	return commitWrite() ? record.profile : nullptr;
+}
+
+// Accounts
+
+// savingExists function returns true if the username has a loaded saving account
+bool accountStore::savingExists(const std::string& _username) const
+{
+	std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+	return savings.find(_username) != savings.end();
+}
+
+// checkingExists function returns true if the username has a loaded checking account
+bool accountStore::checkingExists(const std::string& _username) const
+{
+	std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+	return checkings.find(_username) != checkings.end();
+}
+
+// findSaving function copies the username's saving account into _userSaving and returns true if one exists
+// The copy has the interest earned since its accrual day added; only the next update writes it, so reading never writes
+bool accountStore::findSaving(const std::string& _username, savingAccount& _userSaving) const
+{
+	std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+	std::unordered_map<std::string, savingAccount>::const_iterator saving = savings.find(_username);
+	if (saving == savings.end())
+	{
+		return false;
+	}
+	_userSaving = saving->second;
+	_userSaving.accrueInterest(savingAccount::currentDay());
+	return true;
+}
+
+// findChecking function copies the username's checking account into _userChecking and returns true if one exists
+bool accountStore::findChecking(const std::string& _username, checkingAccount& _userChecking) const
+{
+	std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+	std::unordered_map<std::string, checkingAccount>::const_iterator checking = checkings.find(_username);
+	if (checking == checkings.end())
+	{
+		return false;
+	}
+	_userChecking = checking->second;
+	return true;
+}
+
+// addSaving function stores a new saving account in memory and appends it to userAccountLog.txt or the binary file
+// Returns once the account is on disk, or false if it could not be persisted. An account that could not be written is
+// taken out of memory again; one whose sync failed stays, since its record is written and the next sync saves it
+bool accountStore::addSaving(const savingAccount& _userSaving)
+{
+	const std::string& username = _userSaving.getaccountCustomer().getusername();
+	{
+		std::unique_lock<std::shared_mutex> dataLock(dataMutex);
+		std::unordered_map<std::string, savingAccount>::iterator existing = savings.find(username);
+		bool replacing = existing != savings.end();
+		savingAccount previous;
+		if (replacing)
+		{
+			previous = existing->second;
+		}
+		std::unordered_map<std::string, savingAccount>::iterator account = savings.insert_or_assign(username, _userSaving).first;
+		accountIds.markUsed(_userSaving.getid());
+		idIndex[_userSaving.getid()] = { 'S', &account->first };
+		linkSaving(account->first, &account->second);
+
+		if (binaryAccounts.isOpen())
+		{
+			binaryAccountRecord record;
+			size_t slot = 0;
+			if (binaryAccountFile::makeRecord('S', username, _userSaving.getbalance().getcents(), _userSaving.getinterestRate().getmillionths(), _userSaving.getid(),
+				_userSaving.getdepositCount(), _userSaving.getwithdrawalCount(), _userSaving.getaccrualDay(), record) == false || binaryAccounts.append(record, slot) == false)
+			{
+				// Nothing reached the file, so the account is taken out of memory again
+				idIndex.erase(_userSaving.getid());
+				if (replacing)
+				{
+					account->second = previous;
+				}
+				else
+				{
+					linkSaving(username, nullptr);
+					savings.erase(account);
+				}
+				return false;
+			}
+			savingSlots[username] = slot;
+		}
+		else
+		{
+			persistRequest& request = reusableRequest();
+			appendSaving(request.accountLine, _userSaving);
+			logEntries++;
+			submissions.push(request);
+		}
+	}
+	return commitWrite() && compactIfDue();
+}
+
+// addChecking function stores a new checking account in memory and appends it to userAccountLog.txt or the binary file
+// Returns once the account is on disk, or false if it could not be persisted. An account that could not be written is
+// taken out of memory again; one whose sync failed stays, since its record is written and the next sync saves it
+bool accountStore::addChecking(const checkingAccount& _userChecking)
+{
+	const std::string& username = _userChecking.getaccountCustomer().getusername();
+	{
+		std::unique_lock<std::shared_mutex> dataLock(dataMutex);
+		std::unordered_map<std::string, checkingAccount>::iterator existing = checkings.find(username);
+		bool replacing = existing != checkings.end();
+		checkingAccount previous;
+		if (replacing)
+		{
+			previous = existing->second;
+		}
+		std::unordered_map<std::string, checkingAccount>::iterator account = checkings.insert_or_assign(username, _userChecking).first;
+		accountIds.markUsed(_userChecking.getid());
+		idIndex[_userChecking.getid()] = { 'C', &account->first };
+		linkChecking(account->first, &account->second);
+
+		if (binaryAccounts.isOpen())
+		{
+			binaryAccountRecord record;
+			size_t slot = 0;
+			if (binaryAccountFile::makeRecord('C', username, _userChecking.getbalance().getcents(), _userChecking.getoverdraftLimit().getcents(), _userChecking.getid(),
+				_userChecking.getdepositCount(), _userChecking.getwithdrawalCount(), 0, record) == false || binaryAccounts.append(record, slot) == false)
+			{
+				// Nothing reached the file, so the account is taken out of memory again
+				idIndex.erase(_userChecking.getid());
+				if (replacing)
+				{
+					account->second = previous;
+				}
+				else
+				{
+					linkChecking(username, nullptr);
+					checkings.erase(account);
+				}
+				return false;
+			}
+			checkingSlots[username] = slot;
+		}
+		else
+		{
+			persistRequest& request = reusableRequest();
+			appendChecking(request.accountLine, _userChecking);
+			logEntries++;
+			submissions.push(request);
+		}
+	}
+	return commitWrite() && compactIfDue();
+}
+
+// updateSaving function replaces the stored saving account and appends the new record to userAccountLog.txt,
+// or overwrites its slot when the binary file is in use
+// The account's pending ledger entries are recorded and cleared first
+// Returns once the record is on disk (or in memory between beginBatch and endBatch),
+// or false if the username has no saving account or the record could not be persisted, in which case the stored
+// account is put back as it was
+bool accountStore::updateSaving(savingAccount& _userSaving)
+{
+	traceSpan span("updateSaving", "store");
+	const std::string& username = _userSaving.getaccountCustomer().getusername();
+	savingAccount previous;
+	{
+		// Held exclusively because finding an account copies the stored one under the shared lock
+		std::unique_lock<std::shared_mutex> dataLock(dataMutex);
+		std::unordered_map<std::string, savingAccount>::iterator account = savings.find(username);
+		if (account == savings.end())
+		{
+			return false;
+		}
+		persistRequest& request = reusableRequest();
+		for (const ledgerEntry& entry : _userSaving.getpendingEntries())
+		{
+			request.events.push_back(ledgerEvent{ _userSaving.getid(), entry });
+		}
+		_userSaving.clearpendingEntries();
+		previous = account->second;
+		account->second = _userSaving;
+
+		bool stored = true;
+		if (binaryAccounts.isOpen())
+		{
+			binaryAccountRecord record;
+			std::unordered_map<std::string, size_t>::const_iterator slot = savingSlots.find(username);
+			stored = slot != savingSlots.end()
+				&& binaryAccountFile::makeRecord('S', username, _userSaving.getbalance().getcents(), _userSaving.getinterestRate().getmillionths(), _userSaving.getid(),
+					_userSaving.getdepositCount(), _userSaving.getwithdrawalCount(), _userSaving.getaccrualDay(), record)
+				&& binaryAccounts.update(slot->second, record);
+		}
+		else if (batching == false)
+		{
+			appendSaving(request.accountLine, _userSaving);
+			logEntries++;
+		}
+		if (stored == false)
+		{
+			// Nothing was written or queued, so the stored account is put back
+			account->second = previous;
+			request.clear();
+			return false;
+		}
+		if (request.events.empty() == false || request.accountLine.empty() == false)
+		{
+			submissions.push(request);
+		}
+		if (batching)
+		{
+			return true;
+		}
+	}
+	if (commitWrite() == false)
+	{
+		restoreSaving(previous, _userSaving);
+		return false;
+	}
+	return compactIfDue();
+}
+
+// updateChecking function replaces the stored checking account and appends the new record to userAccountLog.txt,
+// or overwrites its slot when the binary file is in use
+// The account's pending ledger entries are recorded and cleared first
+// Returns once the record is on disk (or in memory between beginBatch and endBatch),
+// or false if the username has no checking account or the record could not be persisted, in which case the stored
+// account is put back as it was
+bool accountStore::updateChecking(checkingAccount& _userChecking)
+{
+	traceSpan span("updateChecking", "store");
+	const std::string& username = _userChecking.getaccountCustomer().getusername();
+	checkingAccount previous;
+	{
+		// Held exclusively because finding an account copies the stored one under the shared lock
+		std::unique_lock<std::shared_mutex> dataLock(dataMutex);
+		std::unordered_map<std::string, checkingAccount>::iterator account = checkings.find(username);
+		if (account == checkings.end())
+		{
+			return false;
+		}
+		persistRequest& request = reusableRequest();
+		for (const ledgerEntry& entry : _userChecking.getpendingEntries())
+		{
+			request.events.push_back(ledgerEvent{ _userChecking.getid(), entry });
+		}
+		_userChecking.clearpendingEntries();
+		previous = account->second;
+		account->second = _userChecking;
+
+		bool stored = true;
+		if (binaryAccounts.isOpen())
+		{
+			binaryAccountRecord record;
+			std::unordered_map<std::string, size_t>::const_iterator slot = checkingSlots.find(username);
+			stored = slot != checkingSlots.end()
+				&& binaryAccountFile::makeRecord('C', username, _userChecking.getbalance().getcents(), _userChecking.getoverdraftLimit().getcents(), _userChecking.getid(),
+					_userChecking.getdepositCount(), _userChecking.getwithdrawalCount(), 0, record)
+				&& binaryAccounts.update(slot->second, record);
+		}
+		else if (batching == false)
+		{
+			appendChecking(request.accountLine, _userChecking);
+			logEntries++;
+		}
+		if (stored == false)
+		{
+			// Nothing was written or queued, so the stored account is put back
+			account->second = previous;
+			request.clear();
+			return false;
+		}
+		if (request.events.empty() == false || request.accountLine.empty() == false)
+		{
+			submissions.push(request);
+		}
+		if (batching)
+		{
+			return true;
+		}
+	}
+	if (commitWrite() == false)
+	{
+		restoreChecking(previous, _userChecking);
+		return false;
+	}
+	return compactIfDue();
+}
+
+// restoreSaving function puts back the saving account an update replaced once the update's sync has failed, if the stored
+// account is still the one the update wrote. The account it puts back is written again, so the next sync does not save
+// the failed update after all
+void accountStore::restoreSaving(const savingAccount& _previous, const savingAccount& _written)
+{
+	const std::string& username = _written.getaccountCustomer().getusername();
+	std::unique_lock<std::shared_mutex> dataLock(dataMutex);
+	std::unordered_map<std::string, savingAccount>::iterator account = savings.find(username);
+	if (account == savings.end() || sameAccountState(account->second, _written) == false || account->second.getaccrualDay() != _written.getaccrualDay())
+	{
+		return;
+	}
+	account->second = _previous;
+	if (binaryAccounts.isOpen())
+	{
+		binaryAccountRecord record;
+		std::unordered_map<std::string, size_t>::const_iterator slot = savingSlots.find(username);
+		if (slot != savingSlots.end() && binaryAccountFile::makeRecord('S', username, _previous.getbalance().getcents(), _previous.getinterestRate().getmillionths(),
+			_previous.getid(), _previous.getdepositCount(), _previous.getwithdrawalCount(), _previous.getaccrualDay(), record))
+		{
+			binaryAccounts.update(slot->second, record);
+		}
+	}
+	else
+	{
+		persistRequest& request = reusableRequest();
+		appendSaving(request.accountLine, _previous);
+		logEntries++;
+		submissions.push(request);
+	}
+}
+
+// restoreChecking function puts back the checking account an update replaced once the update's sync has failed, as
+// restoreSaving does
+void accountStore::restoreChecking(const checkingAccount& _previous, const checkingAccount& _written)
+{
+	const std::string& username = _written.getaccountCustomer().getusername();
+	std::unique_lock<std::shared_mutex> dataLock(dataMutex);
+	std::unordered_map<std::string, checkingAccount>::iterator account = checkings.find(username);
+	if (account == checkings.end() || sameAccountState(account->second, _written) == false)
+	{
+		return;
+	}
+	account->second = _previous;
+	if (binaryAccounts.isOpen())
+	{
+		binaryAccountRecord record;
+		std::unordered_map<std::string, size_t>::const_iterator slot = checkingSlots.find(username);
+		if (slot != checkingSlots.end() && binaryAccountFile::makeRecord('C', username, _previous.getbalance().getcents(), _previous.getoverdraftLimit().getcents(),
+			_previous.getid(), _previous.getdepositCount(), _previous.getwithdrawalCount(), 0, record))
+		{
+			binaryAccounts.update(slot->second, record);
+		}
+	}
+	else
+	{
+		persistRequest& request = reusableRequest();
+		appendChecking(request.accountLine, _previous);
+		logEntries++;
+		submissions.push(request);
+	}
+}
+
+// Accounts by id
+
+// findSavingById function copies the saving account with the id into _userSaving through the id index, without a scan
+// Returns false if no saving account has the id
+bool accountStore::findSavingById(int _id, savingAccount& _userSaving) const
+{
+	std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+	std::unordered_map<int, accountIndexEntry>::const_iterator entry = idIndex.find(_id);
+	if (entry == idIndex.end() || entry->second.type != 'S')
+	{
+		return false;
+	}
+	const savingAccount& saving = savings.at(*entry->second.username);
+	// The username's account may have been replaced by one with another id
+	if (saving.getid() != _id)
+	{
+		return false;
+	}
+	_userSaving = saving;
+	_userSaving.accrueInterest(savingAccount::currentDay());
+	return true;
+}
+
+// findCheckingById function copies the checking account with the id into _userChecking through the id index, without a scan
+// Returns false if no checking account has the id
+bool accountStore::findCheckingById(int _id, checkingAccount& _userChecking) const
+{
+	std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+	std::unordered_map<int, accountIndexEntry>::const_iterator entry = idIndex.find(_id);
+	if (entry == idIndex.end() || entry->second.type != 'C')
+	{
+		return false;
+	}
+	const checkingAccount& checking = checkings.at(*entry->second.username);
+	if (checking.getid() != _id)
+	{
+		return false;
+	}
+	_userChecking = checking;
+	return true;
+}
+
+// depositById function deposits into the saving or checking account with the id, holding that account's lock from the
+// read to the write back as a session does, and leaves the new balance in _balance
+depositResult accountStore::depositById(int _id, money _amount, money& _balance)
+{
+	if (_amount <= money())
+	{
+		return DEPOSIT_INVALID_AMOUNT;
+	}
+
+	std::string username;
+	char type = 0;
+	{
+		std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+		std::unordered_map<int, accountIndexEntry>::const_iterator entry = idIndex.find(_id);
+		if (entry == idIndex.end())
+		{
+			return DEPOSIT_NO_ACCOUNT;
+		}
+		username = *entry->second.username;
+		type = entry->second.type;
+	}
+
+	if (type == 'S')
+	{
+		std::unique_lock<std::mutex> accountLock = lockSaving(username);
+		savingAccount userSaving;
+		if (findSavingById(_id, userSaving) == false)
+		{
+			return DEPOSIT_NO_ACCOUNT;
+		}
+		userSaving.deposit(_amount);
+		_balance = userSaving.getbalance();
+		return updateSaving(userSaving) ? DEPOSITED : DEPOSIT_NOT_PERSISTED;
+	}
+
+	std::unique_lock<std::mutex> accountLock = lockChecking(username);
+	checkingAccount userChecking;
+	if (findCheckingById(_id, userChecking) == false)
+	{
+		return DEPOSIT_NO_ACCOUNT;
+	}
+	userChecking.deposit(_amount);
+	_balance = userChecking.getbalance();
+	return updateChecking(userChecking) ? DEPOSITED : DEPOSIT_NOT_PERSISTED;
+}
+
+// Ids
+
+// allocateId function returns an id no other account has, or 0 if every id is taken
+int accountStore::allocateId()
+{
+	return accountIds.allocate();
+}
+
+// getidAllocator function returns the store's allocator, for sessions that lease blocks of ids
+accountIdAllocator& accountStore::getidAllocator()
+{
+	return accountIds;
+}
+
+// History
+
+// getledger function returns the ledger holding every account's history, for scanning it
+const accountLedger& accountStore::getledger() const
+{
+	return ledger;
+}
+
+// Locking
+
+// lockSaving function locks the username's saving account against other sessions until the returned lock is released
+// Held from finding the account to updating it, so two sessions on the same account cannot lose each other's update
+std::unique_lock<std::mutex> accountStore::lockSaving(const std::string& _username)
+{
+	return lockAccount(savingLocks, _username);
+}
+
+// lockChecking function locks the username's checking account against other sessions until the returned lock is released
+std::unique_lock<std::mutex> accountStore::lockChecking(const std::string& _username)
+{
+	return lockAccount(checkingLocks, _username);
+}
+
+// lockAccount function finds or creates the username's mutex in _locks and locks it
+// The map is only held while the mutex is looked up, so waiting on one account never blocks another
+std::unique_lock<std::mutex> accountStore::lockAccount(std::unordered_map<std::string, std::unique_ptr<std::mutex>>& _locks, const std::string& _username)
+{
+	std::mutex* accountMutex = nullptr;
+	{
+		std::lock_guard<std::mutex> locksLock(accountLocksMutex);
+		std::unique_ptr<std::mutex>& entry = _locks[_username];
+		if (entry == nullptr)
+		{
+			entry = std::make_unique<std::mutex>();
+		}
+		accountMutex = entry.get();
+	}
+	return std::unique_lock<std::mutex>(*accountMutex);
+}
+
+// Persistence
+
+// compact function writes a snapshot of every account to userAccountData.txt and drops the log records it covers,
+// returning once the snapshot is in place
+// Returns false if the snapshot could not be written, in which case the log is kept
+// The binary file is always up to date, so there is nothing to compact when it is in use
+bool accountStore::compact()
+{
+	{
+		std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+		if (binaryAccounts.isOpen())
+		{
+			return true;
+		}
+	}
+	return snapshot(true);
+}
+
+// snapshot function brings userAccountData.txt up to date, so the log can start again from empty
+// With _wait true it waits for a running snapshot, then seals the log and copies every account while holding the data
+// lock exclusively and writes the copy without any store lock held; this is how batches, whose changes are only in
+// memory, are saved. With _wait false it compacts the files on a background thread instead, so the session that filled
+// the log never copies the accounts or stops other sessions, and nothing is done if a snapshot is already running
+// Returns false if, when waiting, the log could not be sealed or the snapshot could not be written
+bool accountStore::snapshot(bool _wait)
+{
+	traceSpan span("snapshot", "store");
+	{
+		std::unique_lock<std::mutex> snapshotLock(snapshotMutex);
+		if (snapshotRunning && _wait == false)
+		{
+			return true;
+		}
+		snapshotDone.wait(snapshotLock, [this]() { return snapshotRunning == false; });
+		snapshotRunning = true;
+	}
+	if (snapshotThread.joinable())
+	{
+		snapshotThread.join();
+	}
+	if (_wait == false)
+	{
+		snapshotThread = std::thread([this]()
+			{
+				compactFiles();
+				finishSnapshot();
+			});
+		return true;
+	}
+
+	accountSnapshot image;
+	bool sealed = false;
+	{
+		std::unique_lock<std::shared_mutex> dataLock(dataMutex);
+		std::lock_guard<std::mutex> logLock(logMutex);
+		sealed = sealLog();
+		if (sealed)
+		{
+			traceSpan copySpan("copyAccounts", "store");
+			image.generation = logGeneration;
+			image.savings.reserve(savings.size());
+			for (const std::pair<const std::string, savingAccount>& saving : savings)
+			{
+				image.savings.push_back(saving.second);
+			}
+			image.checkings.reserve(checkings.size());
+			for (const std::pair<const std::string, checkingAccount>& checking : checkings)
+			{
+				image.checkings.push_back(checking.second);
+			}
+		}
+	}
+	bool written = sealed && writeSnapshot(image);
+	finishSnapshot();
+	return written;
+}
+
+// compactFiles function seals the log and writes a snapshot merged from userAccountData.txt and the sealed segment
+// It holds only the log lock, and only while sealing, so sessions keep reading and writing accounts throughout. The files
+// hold every change but those of a running batch, which endBatch saves with a snapshot of its own afterwards
+bool accountStore::compactFiles()
+{
+	traceSpan span("compactFiles", "io");
+	uint64_t generation = 0;
+	{
+		std::lock_guard<std::mutex> logLock(logMutex);
+		if (sealLog() == false)
+		{
+			return false;
+		}
+		generation = logGeneration;
+	}
+
+	// A later line for an account replaces the earlier one, as load() replays them, and keeps the earlier one's place
+	std::vector<std::string> lines;
+	std::unordered_map<std::string, size_t> accountLines;
+	const std::string inputs[2] = { userAccountDataPath, sealedLogPath() };
+	for (const std::string& input : inputs)
+	{
+		recordReader records;
+		records.open(input);
+		std::string_view line;
+		while (records.nextLine(line))
+		{
+			accountLine account;
+			if (parseAccountLine(line, account) == false)
+			{
+				continue;
+			}
+			std::string key(account.type);
+			key += ':';
+			key.append(account.username.data(), account.username.size());
+			std::pair<std::unordered_map<std::string, size_t>::iterator, bool> added = accountLines.emplace(std::move(key), lines.size());
+			if (added.second)
+			{
+				lines.emplace_back();
+			}
+			std::string& kept = lines[added.first->second];
+			kept.assign(line.data(), line.size());
+			kept += '\n';
+		}
+	}
+
+	std::string newPath = userAccountDataPath + ".new";
+	std::fstream newUserAccountData;
+	newUserAccountData.open(newPath, std::ios::out | std::ios::trunc);
+	std::string generationLine;
+	appendGenerationLine(generationLine, generation);
+	newUserAccountData << generationLine;
+	for (const std::string& line : lines)
+	{
+		newUserAccountData << line;
+	}
+	newUserAccountData.close();
+	span.setargument("accounts", static_cast<int64_t>(lines.size()));
+	return newUserAccountData.fail() == false && installSnapshot(newPath);
+}
+
+void accountStore::finishSnapshot()
+{
+	{
+		std::lock_guard<std::mutex> snapshotLock(snapshotMutex);
+		snapshotRunning = false;
+	}
+	snapshotDone.notify_all();
+}
+
+// sealLog function moves the records of userAccountLog.txt into the sealed segment and starts an empty log,
+// with the log lock held
+// The records are on disk in the sealed segment before the log is emptied. If an earlier snapshot failed and left its
+// segment behind, the records are appended to it, so the segment always holds everything no snapshot has covered yet.
+// Either way the segment then ends with the seal's generation, which the snapshot taken from it starts with.
+bool accountStore::sealLog()
+{
+	traceSpan span("sealLog", "io");
+	accountLog.close();
+	logGeneration++;
+	std::string generationLine;
+	appendGenerationLine(generationLine, logGeneration);
+	std::string sealedPath = sealedLogPath();
+	bool sealed = false;
+	if (std::ifstream(sealedPath).good() == false)
+	{
+		std::fstream activeLog;
+		activeLog.open(userAccountLogPath, std::ios::out | std::ios::app | std::ios::binary);
+		activeLog << generationLine;
+		activeLog.close();
+		sealed = activeLog.fail() == false && syncFile(userAccountLogPath) && replaceFile(userAccountLogPath, sealedPath) && syncDirectory(sealedPath);
+	}
+	else
+	{
+		std::ifstream activeLog(userAccountLogPath, std::ios::in | std::ios::binary);
+		std::fstream sealedLog;
+		sealedLog.open(sealedPath, std::ios::out | std::ios::app | std::ios::binary);
+		if (activeLog.peek() != std::ifstream::traits_type::eof())
+		{
+			sealedLog << activeLog.rdbuf();
+		}
+		sealedLog << generationLine;
+		sealedLog.close();
+		sealed = sealedLog.fail() == false && syncFile(sealedPath);
+	}
+
+	accountLog.open(userAccountLogPath, std::ios::out | (sealed ? std::ios::trunc : std::ios::app));
+	if (sealed)
+	{
+		logEntries = 0;
+	}
+	return sealed && accountLog.good();
+}
+
+// writeSnapshot function writes an account snapshot to a new file and installs it as userAccountData.txt
+bool accountStore::writeSnapshot(const accountSnapshot& _image) const
+{
+	traceSpan span("writeSnapshot", "io");
+	span.setargument("accounts", static_cast<int64_t>(_image.savings.size() + _image.checkings.size()));
+	std::string newPath = userAccountDataPath + ".new";
+	std::fstream newUserAccountData;
+	newUserAccountData.open(newPath, std::ios::out | std::ios::trunc);
+	std::string line;
+	appendGenerationLine(line, _image.generation);
+	newUserAccountData << line;
+	for (const savingAccount& saving : _image.savings)
+	{
+		line.clear();
+		appendSaving(line, saving);
+		newUserAccountData << line;
+	}
+	for (const checkingAccount& checking : _image.checkings)
+	{
+		line.clear();
+		appendChecking(line, checking);
+		newUserAccountData << line;
+	}
+	newUserAccountData.close();
+	return newUserAccountData.fail() == false && installSnapshot(newPath);
+}
+
+// installSnapshot function swaps a written snapshot in for userAccountData.txt in one rename and then deletes the sealed
+// segment, whose records the snapshot now holds
+// A crash at any point leaves either the old file and the sealed segment or the new file; a sealed segment left next
+// to the new file has a generation the new file has reached, so load() deletes it instead of replaying it
+bool accountStore::installSnapshot(const std::string& _newPath) const
+{
+	// The new file must be on disk before it replaces the old one
+	if (syncFile(_newPath) == false || replaceFile(_newPath, userAccountDataPath) == false || syncDirectory(userAccountDataPath) == false)
+	{
+		return false;
+	}
+	traceSpan removeSpan("remove", "io");
+	std::remove(sealedLogPath().c_str());
+	return syncDirectory(sealedLogPath());
+}
+
+// sealedLogPath function returns the path of the sealed log segment, userAccountLog.txt.sealed by default
+std::string accountStore::sealedLogPath() const
+{
+	return userAccountLogPath + ".sealed";
+}
+
+// beginBatch function stops updates from being persisted one at a time until endBatch is called
+void accountStore::beginBatch()
+{
+	std::unique_lock<std::shared_mutex> dataLock(dataMutex);
+	batching = true;
+}
+
+// endBatch function persists every update made since beginBatch with a single write
+// The text store writes a snapshot, which rewrites userAccountData.txt once and empties the log;
+// the binary store flushes its whole mapping once, in the group commit. Either way the group commit then writes the
+// ledger entries queued meanwhile and syncs them once
+bool accountStore::endBatch()
+{
+	bool binary = false;
+	{
+		std::unique_lock<std::shared_mutex> dataLock(dataMutex);
+		batching = false;
+		binary = binaryAccounts.isOpen();
+	}
+	return (binary || snapshot(true)) && committer->commit();
+}
+
+// postInterest function adds the interest accrued up to today to every saving account, splitting the accounts into one
+// contiguous partition per thread, and returns the number of accounts in _accounts
+// The result is persisted with a single write: the text store writes a snapshot, the binary store is flushed once
+// Returns false if the result could not be persisted
+bool accountStore::postInterest(unsigned _threads, size_t& _accounts)
+{
+	traceSpan span("postInterest", "store");
+	std::unique_lock<std::shared_mutex> dataLock(dataMutex);
+
+	std::vector<std::pair<const std::string*, savingAccount*>> accounts;
+	accounts.reserve(savings.size());
+	for (std::pair<const std::string, savingAccount>& saving : savings)
+	{
+		accounts.emplace_back(&saving.first, &saving.second);
+	}
+	_accounts = accounts.size();
+
+	int64_t today = savingAccount::currentDay();
+	unsigned threads = std::max(1u, _threads);
+	size_t partitionSize = (accounts.size() + threads - 1) / threads;
+	std::vector<char> written(threads, 1);
+	std::vector<std::thread> workers;
+	for (unsigned worker = 0; worker < threads && worker * partitionSize < accounts.size(); worker++)
+	{
+		workers.emplace_back([this, &accounts, &written, partitionSize, worker, today]()
+			{
+				size_t end = std::min(accounts.size(), (worker + 1) * partitionSize);
+				traceSpan workerSpan("accrueInterest", "store");
+				workerSpan.setargument("accounts", static_cast<int64_t>(end - worker * partitionSize));
+				// Each worker queues its partition's ledger entries as one request, behind any entries sessions queued before
+				persistRequest request;
+				std::vector<ledgerEvent>& events = request.events;
+				for (size_t i = worker * partitionSize; i < end; i++)
+				{
+					savingAccount& saving = *accounts[i].second;
+					saving.accrueInterest(today);
+					for (const ledgerEntry& entry : saving.getpendingEntries())
+					{
+						events.push_back(ledgerEvent{ saving.getid(), entry });
+					}
+					saving.clearpendingEntries();
+					if (binaryAccounts.isOpen())
+					{
+						binaryAccountRecord record;
+						if (binaryAccountFile::makeRecord('S', *accounts[i].first, saving.getbalance().getcents(), saving.getinterestRate().getmillionths(), saving.getid(),
+							saving.getdepositCount(), saving.getwithdrawalCount(), saving.getaccrualDay(), record) == false
+							|| binaryAccounts.update(savingSlots.at(*accounts[i].first), record) == false)
+						{
+							written[worker] = 0;
+						}
+					}
+				}
+				submissions.push(request);
+			});
+	}
+	for (std::thread& workerThread : workers)
+	{
+		workerThread.join();
+	}
+	if (std::find(written.begin(), written.end(), 0) != written.end())
+	{
+		return false;
+	}
+	if (batching)
+	{
+		return true;
+	}
+	bool binary = binaryAccounts.isOpen();
+	dataLock.unlock();
+	return (binary || snapshot(true)) && committer->commit();
+}
+
+// commitWrite function returns once the write the calling thread just made is on disk, sharing the fsync with
+// every other thread that wrote in the meantime; between beginBatch and endBatch it returns at once
+bool accountStore::commitWrite()
+{
+	traceSpan span("commitWrite", "io");
+	{
+		std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+		if (batching)
+		{
+			return true;
+		}
+	}
+	return committer->commit();
+}
+
+// syncFiles function is the group commit's sync: it writes every queued change to its file and forces onto disk only
+// the files written since the last sync, and only the binary slots changed since then
+// It runs on the committer's thread, the store's persistence thread, so sessions keep queueing while it writes and syncs
+bool accountStore::syncFiles()
+{
+	traceSpan span("syncFiles", "io");
+	size_t count = submissions.drain(drainedRequests);
+	if (writeRequests(count) == false)
+	{
+		return false;
+	}
+	{
+		// Appends can remap the file, so hold the data lock shared while flushing the mapping
+		std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+		if (binaryAccounts.isOpen() && binaryAccounts.sync() == false)
+		{
+			return false;
+		}
+	}
+	// Each flag is cleared only once its file is synced, so a failed sync is retried by the next one
+	if (unsyncedLog)
+	{
+		if (syncFile(userAccountLogPath) == false)
+		{
+			return false;
+		}
+		unsyncedLog = false;
+	}
+	if (unsyncedUsers)
+	{
+		if (syncFile(userDataPath) == false)
+		{
+			return false;
+		}
+		unsyncedUsers = false;
+	}
+	if (unsyncedLedger)
+	{
+		if (ledger.sync() == false)
+		{
+			return false;
+		}
+		unsyncedLedger = false;
+	}
+	return true;
+}
+
+// writeRequests function appends the profiles of the first _count drained requests to userData.txt and their account
+// records to userAccountLog.txt, flushing each file once, and hands all their ledger entries to the ledger in one call
+bool accountStore::writeRequests(size_t _count)
+{
+	if (_count == 0)
+	{
+		return true;
+	}
+	traceSpan span("writeRequests", "io");
+	span.setargument("requests", static_cast<int64_t>(_count));
+
+	const persistRequest* first = drainedRequests.data();
+	const persistRequest* last = first + _count;
+	std::vector<ledgerEvent>& events = drainedEvents;
+	events.clear();
+	bool userLines = false, accountLines = false;
+	for (const persistRequest* request = first; request != last; request++)
+	{
+		events.insert(events.end(), request->events.begin(), request->events.end());
+		userLines = userLines || request->userLine.empty() == false;
+		accountLines = accountLines || request->accountLine.empty() == false;
+	}
+
+
+	if (userLines)
+	{
+		traceSpan appendSpan("appendUsers", "io");
+		unsyncedUsers = true;
+		std::fstream userData;
+		userData.open(userDataPath, std::ios::out | std::ios::app);
+		for (const persistRequest* request = first; request != last; request++)
+		{
+			userData << request->userLine;
+		}
+		userData.close();
+		if (userData.good() == false)
+		{
+			return false;
+		}
+	}
+	if (accountLines)
+	{
+		traceSpan appendSpan("appendLog", "io");
+		std::lock_guard<std::mutex> logLock(logMutex);
+		unsyncedLog = true;
+		for (const persistRequest* request = first; request != last; request++)
+		{
+			accountLog << request->accountLine;
+		}
+		accountLog.flush();
+		if (accountLog.good() == false)
+		{
+			return false;
+		}
+	}
+	unsyncedLedger = unsyncedLedger || events.empty() == false;
+	return ledger.record(events);
+}
+
+// compactIfDue function starts a background compaction once the log reaches compactThreshold entries
+bool accountStore::compactIfDue()
+{
+	if (logEntries < compactThreshold)
+	{
+		return true;
+	}
+	return snapshot(false);
+}
+
+// appendSaving function appends a saving account to _line as one userAccountData.txt line
+void accountStore::appendSaving(std::string& _line, const savingAccount& _userSaving)
+{
+	_line += "Saving";
+	appendField(_line, _userSaving.getaccountCustomer().getusername());
+	appendField(_line, _userSaving.getbalance());
+	appendField(_line, _userSaving.getinterestRate());
+	appendField(_line, int64_t(_userSaving.getid()));
+	appendField(_line, int64_t(_userSaving.getdepositCount()));
+	appendField(_line, int64_t(_userSaving.getwithdrawalCount()));
+	appendField(_line, _userSaving.getaccrualDay());
+	_line += ":\n";
+}
+
+// appendChecking function appends a checking account to _line as one userAccountData.txt line
+void accountStore::appendChecking(std::string& _line, const checkingAccount& _userChecking)
+{
+	_line += "Checking";
+	appendField(_line, _userChecking.getaccountCustomer().getusername());
+	appendField(_line, _userChecking.getbalance());
+	appendField(_line, _userChecking.getoverdraftLimit());
+	appendField(_line, int64_t(_userChecking.getid()));
+	appendField(_line, int64_t(_userChecking.getdepositCount()));
+	appendField(_line, int64_t(_userChecking.getwithdrawalCount()));
+	_line += ":\n";
+}
+
+// Reporting
+
+// fillTable function copies every account's fields into the columns of _table, replacing its rows
+// Saving balances include the interest accrued up to today
+void accountStore::fillTable(accountTable& _table) const
+{
+	std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+	_table.clear();
+	_table.reserve(savings.size(), checkings.size());
+	int64_t today = savingAccount::currentDay();
+	for (const std::pair<const std::string, savingAccount>& saving : savings)
+	{
+		const savingAccount& account = saving.second;
+		_table.addSaving(account.getbalance() + account.getaccruedInterest(today), account.getinterestRate(), account.getid(), account.getdepositCount(), account.getwithdrawalCount());
+	}
+	for (const std::pair<const std::string, checkingAccount>& checking : checkings)
+	{
+		const checkingAccount& account = checking.second;
+		_table.addChecking(account.getbalance(), account.getoverdraftLimit(), account.getid(), account.getdepositCount(), account.getwithdrawalCount());
+	}
+}
+
+// Getters, used for returning the size of the loaded data
+size_t accountStore::getuserCount() const
+{
+	std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+	return users.size();
+}
+
+// getusernameFilterStats function returns the username filter's counters and its false positive rate since load()
+usernameFilterStats accountStore::getusernameFilterStats() const
+{
+	std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+	usernameFilterStats stats;
+	stats.lookups = filterLookups.load();
+	stats.definiteMisses = filterMisses.load();
+	stats.falsePositives = filterFalsePositives.load();
+	uint64_t absent = stats.definiteMisses + stats.falsePositives;
+	stats.falsePositiveRate = absent > 0 ? static_cast<double>(stats.falsePositives) / absent : 0;
+	stats.expectedFalsePositiveRate = usernameFilter.getexpectedFalsePositiveRate();
+	stats.usernames = usernameFilter.getitemCount();
+	stats.filterBytes = usernameFilter.getbyteCount();
+	return stats;
+}
+
+size_t accountStore::getaccountCount() const
+{
+	std::shared_lock<std::shared_mutex> dataLock(dataMutex);
+	return savings.size() + checkings.size();
+}
+
+size_t accountStore::getlogEntries() const
+{
+	return logEntries;
+}
+
+// getcommitCount and getsyncCount return how many writes waited for the disk and how many fsyncs covered them
+uint64_t accountStore::getcommitCount() const
+{
+	return committer->getcommitCount();
+}
+
+uint64_t accountStore::getsyncCount() const
+{
+	return committer->getsyncCount();
+}
+#pragma endregion
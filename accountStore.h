@@ -0,0 +1,225 @@
+#pragma once
+#include "userClasses.h"
+#include "binaryAccountFile.h"
+#include "accountTable.h"
+#include "accountIdAllocator.h"
+#include "accountLedger.h"
+#include "bloomFilter.h"
+#include "groupCommitter.h"
+#include "persistenceQueue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <string>
+#include <unordered_map>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+// userRecord: one profile line of userData.txt
+// profile is shared with every account of the user; saving and checking point at the user's accounts in the savings
+// and checkings maps, or are nullptr while the user has none
+struct userRecord
+{
+	customerHandle profile;
+	std::string password;
+	const savingAccount* saving;
+	const checkingAccount* checking;
+};
+
+// loginRecord: everything a session needs once its user has logged in, found by accountStore::findLogin
+// An account the user does not have is left default constructed, with id 0
+struct loginRecord
+{
+	customerHandle user;
+	savingAccount saving;
+	checkingAccount checking;
+};
+
+// accountIndexEntry: where the account with an id is kept
+// type is 'S' or 'C' and username points at the account's key in the savings or checkings map
+struct accountIndexEntry
+{
+	char type;
+	const std::string* username;
+};
+
+// usernameFilterStats: how the username Bloom filter in front of userExists has done since load()
+// falsePositiveRate is the share of absent usernames the filter let through to the users map
+struct usernameFilterStats
+{
+	uint64_t lookups;
+	uint64_t definiteMisses;
+	uint64_t falsePositives;
+	double falsePositiveRate;
+	double expectedFalsePositiveRate;
+	size_t usernames;
+	size_t filterBytes;
+};
+
+// depositResult: the outcome of accountStore::depositById
+enum depositResult
+{
+	DEPOSITED,
+	DEPOSIT_INVALID_AMOUNT,
+	DEPOSIT_NO_ACCOUNT,
+	DEPOSIT_NOT_PERSISTED
+};
+
+// accountSnapshot: a point-in-time copy of every account, written to userAccountData.txt by a snapshot
+// generation is the last log seal the copy holds
+struct accountSnapshot
+{
+	uint64_t generation;
+	std::vector<savingAccount> savings;
+	std::vector<checkingAccount> checkings;
+};
+
+// AccountStore class declaration
+//
+// Holds every profile and account in memory, keyed by username with one map per account type and by account id through
+// idIndex, so lookups never touch the files. load() reads the files once; afterwards each change is appended to
+// userAccountLog.txt, or stored in the binary file when one is set, and to the account's ledger, and is made durable by
+// the group commit on the store's persistence thread.
+//
+// The store can be shared by several threads. Reads hold the data lock shared and changes hold it exclusively, and a
+// session holds lockSaving or lockChecking from reading an account to writing it back.
+class accountStore
+{
+public:
+	// Constructors
+	accountStore();
+	accountStore(std::string _userDataPath, std::string _userAccountDataPath, std::string _userAccountLogPath);
+	~accountStore();
+
+	// Setters
+	void setcompactThreshold(size_t _compactThreshold);
+	void setbinaryPath(std::string _binaryPath);
+	void setcommitDelay(std::chrono::microseconds _commitDelay);
+	void setledgerPath(std::string _ledgerPath);
+
+	// Loading
+	bool load();
+
+	// Users
+	bool userExists(const std::string& _username) const;
+	bool findUser(const std::string& _username, const std::string& _password, customerHandle& _user) const;
+	bool findLogin(const std::string& _username, const std::string& _password, loginRecord& _login) const;
+	customerHandle addUser(customer _user, const std::string& _password);
+
+	// Accounts
+	bool savingExists(const std::string& _username) const;
+	bool checkingExists(const std::string& _username) const;
+	bool findSaving(const std::string& _username, savingAccount& _userSaving) const;
+	bool findChecking(const std::string& _username, checkingAccount& _userChecking) const;
+	bool addSaving(const savingAccount& _userSaving);
+	bool addChecking(const checkingAccount& _userChecking);
+	bool updateSaving(savingAccount& _userSaving);
+	bool updateChecking(checkingAccount& _userChecking);
+
+	// Accounts by id
+	bool findSavingById(int _id, savingAccount& _userSaving) const;
+	bool findCheckingById(int _id, checkingAccount& _userChecking) const;
+	depositResult depositById(int _id, money _amount, money& _balance);
+
+	// Ids
+	int allocateId();
+	accountIdAllocator& getidAllocator();
+
+	// History
+	const accountLedger& getledger() const;
+
+	// Locking
+	std::unique_lock<std::mutex> lockSaving(const std::string& _username);
+	std::unique_lock<std::mutex> lockChecking(const std::string& _username);
+
+	// Persistence
+	bool compact();
+	void beginBatch();
+	bool endBatch();
+	bool postInterest(unsigned _threads, size_t& _accounts);
+
+	// Reporting
+	void fillTable(accountTable& _table) const;
+
+	// Getters
+	size_t getuserCount() const;
+	usernameFilterStats getusernameFilterStats() const;
+	size_t getaccountCount() const;
+	size_t getlogEntries() const;
+	uint64_t getcommitCount() const;
+	uint64_t getsyncCount() const;
+
+private:
+	void loadUsers();
+	void rebuildUsernameFilter(size_t _capacity);
+	size_t loadAccountRecords(const std::string& _path);
+	bool loadBinaryRecords();
+	customerHandle accountCustomerFor(const std::string& _username) const;
+	void indexAccounts();
+	void linkSaving(const std::string& _username, const savingAccount* _saving);
+	void linkChecking(const std::string& _username, const checkingAccount* _checking);
+	void startAccrual();
+	bool snapshot(bool _wait);
+	void finishSnapshot();
+	bool compactFiles();
+	bool sealLog();
+	bool writeSnapshot(const accountSnapshot& _image) const;
+	bool installSnapshot(const std::string& _newPath) const;
+	std::string sealedLogPath() const;
+	bool compactIfDue();
+	bool commitWrite();
+	void restoreSaving(const savingAccount& _previous, const savingAccount& _written);
+	void restoreChecking(const checkingAccount& _previous, const checkingAccount& _written);
+	bool syncFiles();
+	bool writeRequests(size_t _count);
+	std::unique_lock<std::mutex> lockAccount(std::unordered_map<std::string, std::unique_ptr<std::mutex>>& _locks, const std::string& _username);
+	static void appendSaving(std::string& _line, const savingAccount& _userSaving);
+	static void appendChecking(std::string& _line, const checkingAccount& _userChecking);
+
+	// Attributes
+	std::string userDataPath;
+	std::string userAccountDataPath;
+	std::string userAccountLogPath;
+	std::ofstream accountLog;
+	std::atomic<size_t> logEntries;
+	// The number of the last log seal, guarded by logMutex
+	uint64_t logGeneration;
+	size_t compactThreshold;
+	bool batching;
+	std::string binaryPath;
+	binaryAccountFile binaryAccounts;
+	std::unordered_map<std::string, size_t> savingSlots;
+	std::unordered_map<std::string, size_t> checkingSlots;
+	std::unordered_map<std::string, userRecord> users;
+	bloomFilter usernameFilter;
+	mutable std::atomic<uint64_t> filterLookups;
+	mutable std::atomic<uint64_t> filterMisses;
+	mutable std::atomic<uint64_t> filterFalsePositives;
+	std::unordered_map<std::string, savingAccount> savings;
+	std::unordered_map<std::string, checkingAccount> checkings;
+	accountIdAllocator accountIds;
+	std::unordered_map<int, accountIndexEntry> idIndex;
+	accountLedger ledger;
+	mutable std::shared_mutex dataMutex;
+	mutable std::mutex logMutex;
+	std::mutex accountLocksMutex;
+	std::unordered_map<std::string, std::unique_ptr<std::mutex>> savingLocks;
+	std::unordered_map<std::string, std::unique_ptr<std::mutex>> checkingLocks;
+	std::mutex snapshotMutex;
+	std::condition_variable snapshotDone;
+	bool snapshotRunning;
+	std::thread snapshotThread;
+	persistenceQueue submissions;
+	// Only the persistence thread uses these; they keep their capacity from one sync to the next
+	std::vector<persistRequest> drainedRequests;
+	std::vector<ledgerEvent> drainedEvents;
+	bool unsyncedUsers;
+	bool unsyncedLog;
+	bool unsyncedLedger;
+	// Declared last so its thread stops before the files it syncs are closed and the queue it drains is destroyed
+	std::unique_ptr<groupCommitter> committer;
+};
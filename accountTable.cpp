@@ -0,0 +1,234 @@
+#include "accountTable.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace
+{
+	const size_t lanes = 8;
+
+	// sum function adds up _count values with one running total per lane
+	int64_t sum(const int64_t* _values, size_t _count)
+	{
+		int64_t partial[lanes] = {};
+		size_t i = 0;
+		for (; i + lanes <= _count; i += lanes)
+		{
+			for (size_t lane = 0; lane < lanes; lane++)
+			{
+				partial[lane] += _values[i + lane];
+			}
+		}
+		for (; i < _count; i++)
+		{
+			partial[0] += _values[i];
+		}
+
+		int64_t total = 0;
+		for (size_t lane = 0; lane < lanes; lane++)
+		{
+			total += partial[lane];
+		}
+		return total;
+	}
+
+	// sumBelowZero function adds up the negative values only, as a negative total
+	int64_t sumBelowZero(const int64_t* _values, size_t _count)
+	{
+		int64_t partial[lanes] = {};
+		size_t i = 0;
+		for (; i + lanes <= _count; i += lanes)
+		{
+			for (size_t lane = 0; lane < lanes; lane++)
+			{
+				int64_t value = _values[i + lane];
+				partial[lane] += value < 0 ? value : 0;
+			}
+		}
+		for (; i < _count; i++)
+		{
+			partial[0] += _values[i] < 0 ? _values[i] : 0;
+		}
+
+		int64_t total = 0;
+		for (size_t lane = 0; lane < lanes; lane++)
+		{
+			total += partial[lane];
+		}
+		return total;
+	}
+
+	// countBelow function counts the values less than _edge
+	size_t countBelow(const int64_t* _values, size_t _count, int64_t _edge)
+	{
+		uint32_t partial[lanes] = {};
+		size_t total = 0;
+		size_t i = 0;
+		while (i + lanes <= _count)
+		{
+			// Flush the 32 bit lane counts before they can overflow
+			size_t blockEnd = i + (std::min<size_t>((_count - i) / lanes, 1u << 24) * lanes);
+			for (; i < blockEnd; i += lanes)
+			{
+				for (size_t lane = 0; lane < lanes; lane++)
+				{
+					partial[lane] += _values[i + lane] < _edge ? 1u : 0u;
+				}
+			}
+			for (size_t lane = 0; lane < lanes; lane++)
+			{
+				total += partial[lane];
+				partial[lane] = 0;
+			}
+		}
+		for (; i < _count; i++)
+		{
+			total += _values[i] < _edge ? 1 : 0;
+		}
+		return total;
+	}
+
+	void addRow(accountColumns& _columns, int64_t _balance, int64_t _rate, int _id, int _depositCount, int _withdrawalCount)
+	{
+		_columns.balances.push_back(_balance);
+		_columns.rates.push_back(_rate);
+		_columns.ids.push_back(_id);
+		_columns.depositCounts.push_back(_depositCount);
+		_columns.withdrawalCounts.push_back(_withdrawalCount);
+	}
+
+	void reserveRows(accountColumns& _columns, size_t _rows)
+	{
+		_columns.balances.reserve(_rows);
+		_columns.rates.reserve(_rows);
+		_columns.ids.reserve(_rows);
+		_columns.depositCounts.reserve(_rows);
+		_columns.withdrawalCounts.reserve(_rows);
+	}
+}
+
+#pragma region Account Table Class Implementation
+const int64_t accountTable::histogramEdges[accountReport::histogramBuckets - 1] = { 0, 10000, 100000, 1000000, 10000000 };
+
+// Constructors, used for account table creation
+accountTable::accountTable()
+{
+}
+
+// Rows
+
+// clear function removes every row, keeping the allocated columns for the next fill
+void accountTable::clear()
+{
+	accountColumns* tables[2] = { &savings, &checkings };
+	for (accountColumns* columns : tables)
+	{
+		columns->balances.clear();
+		columns->rates.clear();
+		columns->ids.clear();
+		columns->depositCounts.clear();
+		columns->withdrawalCounts.clear();
+	}
+}
+
+void accountTable::reserve(size_t _savingAccounts, size_t _checkingAccounts)
+{
+	reserveRows(savings, _savingAccounts);
+	reserveRows(checkings, _checkingAccounts);
+}
+
+void accountTable::addSaving(money _balance, fixedRate _interestRate, int _id, int _depositCount, int _withdrawalCount)
+{
+	addRow(savings, _balance.getcents(), _interestRate.getmillionths(), _id, _depositCount, _withdrawalCount);
+}
+
+void accountTable::addChecking(money _balance, money _overdraftLimit, int _id, int _depositCount, int _withdrawalCount)
+{
+	addRow(checkings, _balance.getcents(), _overdraftLimit.getcents(), _id, _depositCount, _withdrawalCount);
+}
+
+// Getters, used for returning the columns
+const accountColumns& accountTable::getsavings() const
+{
+	return savings;
+}
+
+const accountColumns& accountTable::getcheckings() const
+{
+	return checkings;
+}
+
+size_t accountTable::getaccountCount() const
+{
+	return savings.balances.size() + checkings.balances.size();
+}
+
+// Reports
+
+// report function computes total deposits, overdraft exposure and the balance histogram in a few passes over the balance columns
+// Deposits are the saving balances plus the checking balances above 0; exposure is the checking balances below 0 as a positive
+// amount, reported next to the sum of every checking account's overdraft limit
+accountReport accountTable::report() const
+{
+	const int64_t* savingBalances = savings.balances.data();
+	const int64_t* checkingBalances = checkings.balances.data();
+	size_t savingCount = savings.balances.size();
+	size_t checkingCount = checkings.balances.size();
+
+	accountReport result;
+	result.savingAccounts = savingCount;
+	result.checkingAccounts = checkingCount;
+	result.savingDeposits = money::fromCents(sum(savingBalances, savingCount));
+	int64_t checkingBelowZero = sumBelowZero(checkingBalances, checkingCount);
+	result.checkingDeposits = money::fromCents(sum(checkingBalances, checkingCount) - checkingBelowZero);
+	result.overdraftExposure = money::fromCents(-checkingBelowZero);
+	result.overdraftLimits = money::fromCents(sum(checkings.rates.data(), checkingCount));
+	result.overdrawnAccounts = countBelow(checkingBalances, checkingCount, 0);
+
+	size_t previousBelow = 0;
+	for (size_t edge = 0; edge < accountReport::histogramBuckets - 1; edge++)
+	{
+		size_t below = countBelow(savingBalances, savingCount, histogramEdges[edge]) + countBelow(checkingBalances, checkingCount, histogramEdges[edge]);
+		result.histogram[edge] = below - previousBelow;
+		previousBelow = below;
+	}
+	result.histogram[accountReport::histogramBuckets - 1] = savingCount + checkingCount - previousBelow;
+	return result;
+}
+#pragma endregion
+
+#pragma region Report Functions
+// printReport function prints a report in the same layout as the account printInfo functions
+void printReport(const accountReport& _report)
+{
+	std::cout << std::setw(30) << std::left << "Saving accounts:" << _report.savingAccounts << "\n";
+	std::cout << std::setw(30) << std::left << "Checking accounts:" << _report.checkingAccounts << "\n";
+	std::cout << std::setw(30) << std::left << "Saving deposits:" << _report.savingDeposits << "\n";
+	std::cout << std::setw(30) << std::left << "Checking deposits:" << _report.checkingDeposits << "\n";
+	std::cout << std::setw(30) << std::left << "Total deposits:" << _report.savingDeposits + _report.checkingDeposits << "\n";
+	std::cout << std::setw(30) << std::left << "Overdrawn accounts:" << _report.overdrawnAccounts << "\n";
+	std::cout << std::setw(30) << std::left << "Overdraft exposure:" << _report.overdraftExposure << "\n";
+	std::cout << std::setw(30) << std::left << "Overdraft limits:" << _report.overdraftLimits << "\n";
+
+	std::cout << "\nBalance histogram\n";
+	for (size_t bucket = 0; bucket < accountReport::histogramBuckets; bucket++)
+	{
+		std::string label;
+		if (bucket == 0)
+		{
+			label = "Below 0:";
+		}
+		else if (bucket == accountReport::histogramBuckets - 1)
+		{
+			label = std::to_string(accountTable::histogramEdges[bucket - 1] / money::scale) + " and above:";
+		}
+		else
+		{
+			label = std::to_string(accountTable::histogramEdges[bucket - 1] / money::scale) + " to "
+				+ std::to_string(accountTable::histogramEdges[bucket] / money::scale) + ":";
+		}
+		std::cout << std::setw(30) << std::left << label << _report.histogram[bucket] << "\n";
+	}
+}
+#pragma endregion
@@ -0,0 +1,69 @@
+#pragma once
+#include "money.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// accountColumns: the fields of one account type, one array per field
+// Row i of every array belongs to the same account; balances are in cents
+// and rates holds the interest rate in millionths or the overdraft limit in cents
+struct accountColumns
+{
+	std::vector<int64_t> balances;
+	std::vector<int64_t> rates;
+	std::vector<int32_t> ids;
+	std::vector<int32_t> depositCounts;
+	std::vector<int32_t> withdrawalCounts;
+};
+
+// accountReport: the aggregates accountTable::report computes over the whole book
+// histogram[0] counts negative balances and histogram[i] counts balances from histogramEdges[i - 1] up to histogramEdges[i]
+struct accountReport
+{
+	static const size_t histogramBuckets = 6;
+
+	size_t savingAccounts;
+	size_t checkingAccounts;
+	money savingDeposits;
+	money checkingDeposits;
+	money overdraftExposure;
+	money overdraftLimits;
+	size_t overdrawnAccounts;
+	size_t histogram[histogramBuckets];
+};
+
+// AccountTable class declaration
+//
+// Holds the accounts as columns instead of account objects, so a scan over balances reads only balances
+// and never the customer profile every account points to. Balances are whole cents, so every total is exact,
+// and the reductions keep several independent running totals so the compiler can keep them in vector registers.
+class accountTable
+{
+public:
+	// Constructors
+	accountTable();
+
+	// Rows
+	void clear();
+	void reserve(size_t _savingAccounts, size_t _checkingAccounts);
+	void addSaving(money _balance, fixedRate _interestRate, int _id, int _depositCount, int _withdrawalCount);
+	void addChecking(money _balance, money _overdraftLimit, int _id, int _depositCount, int _withdrawalCount);
+
+	// Getters
+	const accountColumns& getsavings() const;
+	const accountColumns& getcheckings() const;
+	size_t getaccountCount() const;
+
+	// Reports
+	accountReport report() const;
+
+	// Bucket edges in cents
+	static const int64_t histogramEdges[accountReport::histogramBuckets - 1];
+
+private:
+	// Attributes
+	accountColumns savings;
+	accountColumns checkings;
+};
+
+void printReport(const accountReport& _report);
@@ -0,0 +1,233 @@
+#include "bankFunctions.h"
+#include "operationMetrics.h"
+#include <iostream>
+
+#pragma region Bank Functions
+bool loadUser(customerHandle& _user, const accountStore& _store, const std::string& _passwordInput, const std::string& _usernameInput)
+{
+	/*
+		Called from the session server's login, which only needs the profile
+
+		Looks up the username in the store and checks the password against the stored profile
+
+		By default, the program returns false.
+		The function returns true and user data is loaded if a match is found.
+	*/
+
+	operationTimer timer(METRIC_LOAD_USER);
+
+	bool loginSuccess = false;
+
+	if ((_usernameInput != "") && (_passwordInput != "") && _store.findUser(_usernameInput, _passwordInput, _user))
+	{
+		loginSuccess = true;
+	}
+	return loginSuccess;
+}
+
+bool loadLogin(loginRecord& _login, const accountStore& _store, const std::string& _passwordInput, const std::string& _usernameInput)
+{
+	/*
+		Called from login()
+
+		Checks the username and password like loadUser, and in the same store lookup loads the profile
+		and the saving and checking accounts of the user into _login.
+		An account the user does not have is loaded with id 0.
+
+		returns true if a match is found
+	*/
+
+	operationTimer timer(METRIC_LOAD_LOGIN);
+
+	return (_usernameInput != "") && (_passwordInput != "") && _store.findLogin(_usernameInput, _passwordInput, _login);
+}
+
+void loadAccounts(const customer& _user, checkingAccount& _userChecking, savingAccount& _userSaving, const accountStore& _store)
+{
+	/*
+		Called from the benchmarks, which time it against loadLogin
+
+		Looks up the saving and checking accounts of the loaded user in the store
+		and loads them into _userSaving or _userChecking respectively.
+
+		An account that is not found leaves the passed account untouched (id stays 0).
+	*/
+
+	operationTimer timer(METRIC_LOAD_ACCOUNTS);
+
+	_store.findSaving(_user.getusername(), _userSaving);
+	_store.findChecking(_user.getusername(), _userChecking);
+}
+
+bool userExistance(const accountStore& _store, const std::string& _usernameInput)
+{
+	/*
+		Called by singUp()
+
+		Checks the store for a username matching the input username
+		A username that is not taken is usually ruled out by the store's username filter alone
+
+		returns true if a match is found
+	*/
+
+	operationTimer timer(METRIC_USER_EXISTANCE);
+
+	return _store.userExists(_usernameInput);
+}
+
+bool savingExistance(const accountStore& _store, const customer& _user)
+{
+	/*
+		Called by createAccount()
+
+		Checks the store for a saving account with the loaded _user username
+
+		returns true if a match is found
+	*/
+
+	operationTimer timer(METRIC_SAVING_EXISTANCE);
+
+	return _store.savingExists(_user.getusername());
+}
+
+bool checkingExistance(const accountStore& _store, const customer& _user)
+{
+	/*
+		Called by createAccount()
+
+		Checks the store for a checking account with the loaded _user username
+
+		returns true if a match is found
+	*/
+
+	operationTimer timer(METRIC_CHECKING_EXISTANCE);
+
+	return _store.checkingExists(_user.getusername());
+}
+
+bool createSaving(accountStore& _store, const customerHandle& _user, int _id, savingAccount& _userSaving)
+{
+	/*
+		Called by createAccount()
+
+		_id comes from the store's accountIdAllocator, so no other account has it; 0 means every id is taken
+
+		sets account values with default values and the ID
+
+		stores account in the store, which appends it to userAccountLog.txt or userAccountData.bin
+		returns false if there was no ID or the account could not be stored
+	*/
+
+	operationTimer timer(METRIC_CREATE_SAVING);
+
+	if (_id == 0)
+	{
+		std::cout << "ERROR: No account IDs left\n";
+		return false;
+	}
+
+	_userSaving.setaccountCustomer(_user);
+	_userSaving.setbalance(money());
+	_userSaving.setinterestRate(fixedRate::fromMillionths(50000));
+	_userSaving.setid(_id);
+	_userSaving.setdepositCount(0);
+	_userSaving.setwithdrawalCount(0);
+
+	if (_store.addSaving(_userSaving) == false)
+	{
+		std::cout << "ERROR: File handling\n";
+		return false;
+	}
+	return true;
+}
+
+bool createChecking(accountStore& _store, const customerHandle& _user, int _id, checkingAccount& _userChecking)
+{
+	/*
+		Called by createAccount()
+
+		_id comes from the store's accountIdAllocator, so no other account has it; 0 means every id is taken
+
+		sets account values with default values and the ID
+
+		stores account in the store, which appends it to userAccountLog.txt or userAccountData.bin
+		returns false if there was no ID or the account could not be stored
+	*/
+
+	operationTimer timer(METRIC_CREATE_CHECKING);
+
+	if (_id == 0)
+	{
+		std::cout << "ERROR: No account IDs left\n";
+		return false;
+	}
+
+	_userChecking.setaccountCustomer(_user);
+	_userChecking.setbalance(money());
+	_userChecking.setoverdraftLimit(money::fromCents(2500));
+	_userChecking.setid(_id);
+	_userChecking.setdepositCount(0);
+	_userChecking.setwithdrawalCount(0);
+
+	if (_store.addChecking(_userChecking) == false)
+	{
+		std::cout << "ERROR: File handling\n";
+		return false;
+	}
+	return true;
+}
+
+bool updateSavingAccount(savingAccount& _userSaving, accountStore& _store)
+{
+	/*
+		Replaces the current user's saving account in the store with the loaded saving account
+		The store appends the new record to userAccountLog.txt; userAccountData.txt is only
+		rewritten when the log is compacted
+
+		returns false if the account could not be stored, after reloading _userSaving from the store
+		so it does not show a balance that was not saved
+	*/
+
+	bool updated = false;
+	{
+		// The reload after a failure is not part of the update
+		operationTimer timer(METRIC_UPDATE_SAVING);
+		updated = _store.updateSaving(_userSaving);
+	}
+
+	if (updated == false)
+	{
+		std::cout << "ERROR: File handling\n";
+		std::string username = _userSaving.getaccountCustomer().getusername();
+		_store.findSaving(username, _userSaving);
+	}
+	return updated;
+}
+
+bool updateCheckingAccount(checkingAccount& _userChecking, accountStore& _store)
+{
+	/*
+		Replaces the current user's checking account in the store with the loaded checking account
+		The store appends the new record to userAccountLog.txt; userAccountData.txt is only
+		rewritten when the log is compacted
+
+		returns false if the account could not be stored, after reloading _userChecking from the store
+		so it does not show a balance that was not saved
+	*/
+
+	bool updated = false;
+	{
+		// The reload after a failure is not part of the update
+		operationTimer timer(METRIC_UPDATE_CHECKING);
+		updated = _store.updateChecking(_userChecking);
+	}
+
+	if (updated == false)
+	{
+		std::cout << "ERROR: File handling\n";
+		std::string username = _userChecking.getaccountCustomer().getusername();
+		_store.findChecking(username, _userChecking);
+	}
+	return updated;
+}
+#pragma endregion
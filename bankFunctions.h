@@ -0,0 +1,18 @@
+#pragma once
+#include "userClasses.h"
+#include "accountStore.h"
+#include <string>
+
+// Function prototypes: Other functions
+//
+// Defined in bankFunctions.cpp, shared by the program and the benchmark executable. These do not prompt or pause, so the benchmarks can drive them directly.
+bool loadUser(customerHandle& _user, const accountStore& _store, const std::string& _passwordInput, const std::string& _usernameInput);
+bool loadLogin(loginRecord& _login, const accountStore& _store, const std::string& _passwordInput, const std::string& _usernameInput);
+void loadAccounts(const customer& _user, checkingAccount& _userChecking, savingAccount& _userSaving, const accountStore& _store);
+bool userExistance(const accountStore& _store, const std::string& _usernameInput);
+bool savingExistance(const accountStore& _store, const customer& _user);
+bool checkingExistance(const accountStore& _store, const customer& _user);
+bool createSaving(accountStore& _store, const customerHandle& _user, int _id, savingAccount& _userSaving);
+bool createChecking(accountStore& _store, const customerHandle& _user, int _id, checkingAccount& _userChecking);
+bool updateSavingAccount(savingAccount& _userSaving, accountStore& _store);
+bool updateCheckingAccount(checkingAccount& _userChecking, accountStore& _store);
@@ -0,0 +1,134 @@
+#include "batchProcessor.h"
+#include "recordParser.h"
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+	// resultName function returns the word written to the result file for a withdrawal outcome
+	const char* resultName(withdrawalResult _result)
+	{
+		switch (_result)
+		{
+		case WITHDRAWN:
+			return "Withdrawn";
+		case WITHDRAWN_WITH_FEE:
+			return "WithdrawnWithFee";
+		case INVALID_AMOUNT:
+			return "InvalidAmount";
+		default:
+			return "InsufficientBalance";
+		}
+	}
+
+	// applyTransaction function applies one deposit or withdrawal to an account with the same rules as the menus
+	// Returns the result word, sets _changed if the account was modified and leaves the new balance in _balance
+	template <typename accountClass>
+	const char* applyTransaction(accountClass& _account, money _amount, bool& _changed, money& _balance)
+	{
+		const char* result = "Deposited";
+		if (_amount > money())
+		{
+			_account.deposit(_amount);
+			_changed = true;
+		}
+		else
+		{
+			withdrawalResult withdrawal = _account.applyWithdrawal(-_amount);
+			_changed = withdrawal == WITHDRAWN || withdrawal == WITHDRAWN_WITH_FEE;
+			result = resultName(withdrawal);
+		}
+		_balance = _account.getbalance();
+		return result;
+	}
+}
+
+#pragma region Batch Processing Functions
+// runBatch function reads _transactionPath in one pass, applies every transaction to the store and writes a result line for each
+// Result lines are line number:username:account type:amount:result:balance: where result is Deposited, Withdrawn,
+// WithdrawnWithFee, InvalidAmount, InsufficientBalance, NoAccount or Malformed
+// Returns false if the transaction file could not be read or the store could not be persisted
+bool runBatch(accountStore& _store, const std::string& _transactionPath, const std::string& _resultPath)
+{
+	recordReader transactions;
+	if (transactions.open(_transactionPath) == false)
+	{
+		std::cout << "ERROR: Could not open " << _transactionPath << "\n";
+		return false;
+	}
+
+	std::ofstream results(_resultPath, std::ios::out | std::ios::trunc);
+	if (results.is_open() == false)
+	{
+		std::cout << "ERROR: Could not open " << _resultPath << "\n";
+		return false;
+	}
+
+	savingAccount saving;
+	checkingAccount checking;
+	size_t lineNumber = 0, applied = 0, rejected = 0;
+	std::string_view line;
+
+	_store.beginBatch();
+	while (transactions.nextLine(line))
+	{
+		lineNumber++;
+		if (line.empty())
+		{
+			continue;
+		}
+
+		// username, account type, amount
+		std::string_view fields[3];
+		money amount;
+		money balance;
+		const char* result = "Malformed";
+		bool changed = false;
+
+		if (splitRecord(line, fields, 3) == 3 && parseMoney(fields[2], amount) && amount != money())
+		{
+			std::string username(fields[0]);
+			if (fields[1] == "Saving" && _store.findSaving(username, saving))
+			{
+				result = applyTransaction(saving, amount, changed, balance);
+				if (changed)
+				{
+					_store.updateSaving(saving);
+				}
+			}
+			else if (fields[1] == "Checking" && _store.findChecking(username, checking))
+			{
+				result = applyTransaction(checking, amount, changed, balance);
+				if (changed)
+				{
+					_store.updateChecking(checking);
+				}
+			}
+			else if (fields[1] == "Saving" || fields[1] == "Checking")
+			{
+				result = "NoAccount";
+			}
+		}
+
+		if (changed)
+		{
+			applied++;
+		}
+		else
+		{
+			rejected++;
+		}
+		results << lineNumber << ":" << fields[0] << ":" << fields[1] << ":" << fields[2] << ":" << result << ":" << balance << ":\n";
+	}
+	transactions.close();
+	results.close();
+
+	bool persisted = _store.endBatch();
+	std::cout << "Applied " << applied << " of " << lineNumber << " transactions, " << rejected << " rejected\n";
+	if (persisted == false)
+	{
+		std::cout << "ERROR: File handling\n";
+	}
+	return persisted && results.good();
+}
+#pragma endregion
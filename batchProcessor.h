@@ -0,0 +1,11 @@
+#pragma once
+#include "accountStore.h"
+#include <string>
+
+// Batch processing functions
+//
+// Applies a file of deposits and withdrawals without the interactive menus.
+// Each transaction line is username:account type:amount: where the account type is Saving or Checking
+// and a positive amount is a deposit and a negative amount is a withdrawal.
+// One result line is written per transaction line, and the store is persisted once at the end.
+bool runBatch(accountStore& _store, const std::string& _transactionPath, const std::string& _resultPath);
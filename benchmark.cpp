@@ -0,0 +1,455 @@
+#include "benchmark.h"
+#include "bankFunctions.h"
+#include "datasetGenerator.h"
+#include "operationMetrics.h"
+#include "recordParser.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// Counts this thread's calls to operator new, so the benchmarks can report heap allocations per operation
+	thread_local uint64_t allocationCount = 0;
+
+	// Deposits that may grow the store's reusable buffers, and deposits after them that must not allocate
+	const size_t depositWarmUp = 64;
+	const size_t depositChecks = 1000;
+}
+
+// The global allocation functions are replaced only to count calls, and only in the benchmark executable; the banking program
+// keeps the default allocator. Memory still comes from malloc
+void* operator new(std::size_t _size)
+{
+	allocationCount++;
+	void* memory = std::malloc(_size == 0 ? 1 : _size);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void operator delete(void* _memory) noexcept
+{
+	std::free(_memory);
+}
+
+void operator delete(void* _memory, std::size_t) noexcept
+{
+	std::free(_memory);
+}
+
+namespace
+{
+	// makeAccountLines function builds _lines account records in the userAccountData.txt format
+	std::vector<std::string> makeAccountLines(size_t _lines)
+	{
+		std::vector<std::string> lines;
+		lines.reserve(_lines);
+		for (size_t i = 0; i < _lines; i++)
+		{
+			std::stringstream line;
+			if (i % 2 == 0)
+			{
+				line << "Saving:user" << i << ":" << (i % 100000) * 1.25f << ":" << .05 << ":" << 100000 + (i % 900000) << ":" << i % 50 << ":" << i % 30 << ":";
+			}
+			else
+			{
+				line << "Checking:user" << i << ":" << (i % 100000) * 0.75f << ":" << 25 << ":" << 100000 + (i % 900000) << ":" << i % 50 << ":" << i % 30 << ":";
+			}
+			lines.push_back(line.str());
+		}
+		return lines;
+	}
+
+	// parseWithStringstream function parses a line the way loadAccounts did before recordParser, returning a checksum
+	double parseWithStringstream(const std::string& _line)
+	{
+		std::stringstream ss(_line);
+		std::string accountType, usernameAccount;
+		std::string balanceString, rateString, idString, depositCountString, withdrawalCountString;
+		float balance = 0, rate = 0;
+		int id = 0, depositCount = 0, withdrawalCount = 0;
+
+		std::getline(ss, accountType, ':');
+		std::getline(ss, usernameAccount, ':');
+		std::getline(ss, balanceString, ':');
+		std::getline(ss, rateString, ':');
+		std::getline(ss, idString, ':');
+		std::getline(ss, depositCountString, ':');
+		std::getline(ss, withdrawalCountString, ':');
+
+		std::stringstream balanceConv, rateConv, idConv, depositCountConv, withdrawalCountConv;
+		balanceConv << balanceString;
+		balanceConv >> balance;
+		rateConv << rateString;
+		rateConv >> rate;
+		idConv << idString;
+		idConv >> id;
+		depositCountConv << depositCountString;
+		depositCountConv >> depositCount;
+		withdrawalCountConv << withdrawalCountString;
+		withdrawalCountConv >> withdrawalCount;
+
+		return balance + rate + id + depositCount + withdrawalCount + accountType.size() + usernameAccount.size();
+	}
+
+	// parseWithRecordParser function parses a line with parseAccountLine, returning the same checksum
+	double parseWithRecordParser(const std::string& _line)
+	{
+		accountLine account;
+		if (parseAccountLine(_line, account) == false)
+		{
+			return 0;
+		}
+		double rate = account.type == "Saving" ? static_cast<double>(account.interestRate.getmillionths()) / fixedRate::scale
+			: static_cast<double>(account.overdraftLimit.getcents()) / money::scale;
+		return static_cast<double>(account.balance.getcents()) / money::scale + rate + account.id + account.depositCount + account.withdrawalCount + account.type.size() + account.username.size();
+	}
+
+	// printResult function prints one benchmark result as a JSON line
+	void printResult(const char* _benchmark, const char* _path, size_t _operations, double _seconds, double _checksum)
+	{
+		std::cout << "{\"benchmark\":\"" << _benchmark << "\",\"path\":\"" << _path << "\",\"operations\":" << _operations
+			<< ",\"seconds\":" << _seconds << ",\"operationsPerSecond\":" << (_seconds > 0 ? _operations / _seconds : 0)
+			<< ",\"checksum\":" << std::fixed << _checksum << std::defaultfloat << "}\n";
+	}
+
+	// latencyRecorder: collects the duration and heap allocation count of every timed operation of one benchmark
+	class latencyRecorder
+	{
+	public:
+		latencyRecorder(const char* _benchmark, size_t _accounts)
+		{
+			benchmark = _benchmark;
+			accounts = _accounts;
+			allocations = 0;
+		}
+
+		// time function runs _operation once and records how long it took and how often it allocated
+		template <typename operationType>
+		void time(operationType _operation)
+		{
+			uint64_t allocationsBefore = allocationCount;
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			_operation();
+			std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+			allocations += allocationCount - allocationsBefore;
+			nanoseconds.push_back(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+		}
+
+		// print function prints throughput, the p50, p99 and max latency and the allocations per operation as a JSON line
+		void print()
+		{
+			uint64_t total = 0;
+			for (uint64_t sample : nanoseconds)
+			{
+				total += sample;
+			}
+			std::sort(nanoseconds.begin(), nanoseconds.end());
+
+			std::cout << "{\"benchmark\":\"" << benchmark << "\",\"accounts\":" << accounts << ",\"operations\":" << nanoseconds.size()
+				<< ",\"operationsPerSecond\":" << (total > 0 ? nanoseconds.size() * 1e9 / total : 0)
+				<< ",\"p50Nanoseconds\":" << percentile(0.50) << ",\"p99Nanoseconds\":" << percentile(0.99)
+				<< ",\"maxNanoseconds\":" << percentile(1.0)
+				<< ",\"allocationsPerOperation\":" << (nanoseconds.empty() ? 0 : static_cast<double>(allocations) / nanoseconds.size()) << "}\n";
+		}
+
+
+	private:
+		uint64_t percentile(double _fraction) const
+		{
+			if (nanoseconds.empty())
+			{
+				return 0;
+			}
+			size_t index = static_cast<size_t>(_fraction * (nanoseconds.size() - 1) + 0.5);
+			return nanoseconds[index];
+		}
+
+		const char* benchmark;
+		size_t accounts;
+		uint64_t allocations;
+		std::vector<uint64_t> nanoseconds;
+	};
+
+	// printPhase function prints the p50, p99 and max latency of one operation timed inside the store as a JSON line
+	void printPhase(operationMetric _metric, size_t _accounts)
+	{
+		const latencyHistogram& histogram = operationHistogram(_metric);
+		std::cout << "{\"benchmark\":\"" << operationName(_metric) << "\",\"accounts\":" << _accounts << ",\"operations\":" << histogram.getcount()
+			<< ",\"p50Nanoseconds\":" << histogram.getpercentile(0.50) << ",\"p99Nanoseconds\":" << histogram.getpercentile(0.99)
+			<< ",\"maxNanoseconds\":" << histogram.getmaxNanoseconds() << "}\n";
+	}
+
+	// sampleCredentials function reads up to _samples evenly spaced usernames and passwords from a userData.txt file
+	std::vector<std::pair<std::string, std::string>> sampleCredentials(const std::string& _userDataPath, size_t _customers, size_t _samples)
+	{
+		std::vector<std::pair<std::string, std::string>> credentials;
+		size_t stride = std::max<size_t>(1, _customers / std::max<size_t>(1, _samples));
+		recordReader userData;
+		userData.open(_userDataPath);
+		std::string_view line;
+		for (size_t lineNumber = 0; userData.nextLine(line) && credentials.size() < _samples; lineNumber++)
+		{
+			std::string_view fields[7];
+			if (lineNumber % stride == 0 && splitRecord(line, fields, 7) == 7)
+			{
+				credentials.emplace_back(std::string(fields[0]), std::string(fields[6]));
+			}
+		}
+		return credentials;
+	}
+
+	// depositAllocations function deposits into the checking accounts of up to depositWarmUp + depositChecks users and
+	// returns how often the deposits after the first depositWarmUp allocated, which should be never
+	// Compaction is turned off first, since folding the log into a snapshot allocates by design and is not part of a deposit
+	uint64_t depositAllocations(accountStore& _store, const std::vector<customerHandle>& _users)
+	{
+		_store.setcompactThreshold(SIZE_MAX);
+		uint64_t allocations = 0;
+		for (size_t i = 0; i < depositWarmUp + depositChecks && i < _users.size(); i++)
+		{
+			checkingAccount userChecking;
+			if (_store.findChecking(_users[i]->getusername(), userChecking) == false)
+			{
+				continue;
+			}
+			uint64_t allocationsBefore = allocationCount;
+			userChecking.deposit(money::fromCents(100));
+			updateCheckingAccount(userChecking, _store);
+			if (i >= depositWarmUp)
+			{
+				allocations += allocationCount - allocationsBefore;
+			}
+		}
+		return allocations;
+	}
+
+	// runDatasetBenchmarks function generates a dataset of about _accounts accounts in _directory and times every
+	// banking operation against it
+	// Returns false if the dataset could not be generated or a deposit allocated once the store's buffers were warm
+	bool runDatasetBenchmarks(size_t _accounts, const std::string& _directory)
+	{
+		const size_t samples = std::min<size_t>(_accounts, 10000);
+
+		generatorOptions options = defaultGeneratorOptions();
+		options.customers = _accounts;
+		options.savingPercent = 50;
+		options.checkingPercent = 50;
+		options.userDataPath = _directory + "/userData.txt";
+		options.userAccountDataPath = _directory + "/userAccountData.txt";
+		options.userAccountLogPath = _directory + "/userAccountLog.txt";
+		options.binaryPath = _directory + "/userAccountData.bin";
+		options.ledgerPath = _directory + "/userLedger";
+		if (generateDataset(options) == false)
+		{
+			std::cout << "ERROR: Could not generate the dataset in " << _directory << "\n";
+			return false;
+		}
+
+		accountStore store(options.userDataPath, options.userAccountDataPath, options.userAccountLogPath);
+		store.setledgerPath(options.ledgerPath);
+		latencyRecorder load("load", _accounts);
+		load.time([&store]() { store.load(); });
+		load.print();
+
+		std::vector<std::pair<std::string, std::string>> credentials = sampleCredentials(options.userDataPath, options.customers, samples);
+		std::vector<customerHandle> users(credentials.size());
+
+		latencyRecorder loadUserLatency("loadUser", _accounts);
+		for (size_t i = 0; i < credentials.size(); i++)
+		{
+			loadUserLatency.time([&]() { loadUser(users[i], store, credentials[i].second, credentials[i].first); });
+		}
+		loadUserLatency.print();
+
+		latencyRecorder loadAccountsLatency("loadAccounts", _accounts);
+		for (const customerHandle& user : users)
+		{
+			checkingAccount userChecking;
+			savingAccount userSaving;
+			loadAccountsLatency.time([&]() { loadAccounts(*user, userChecking, userSaving, store); });
+		}
+		loadAccountsLatency.print();
+
+		// loadUser and loadAccounts are the two phases of a login done separately; loadLogin does both in one lookup,
+		// whose own phases are timed inside the store
+		const operationMetric loginPhases[] = { METRIC_LOGIN_CREDENTIALS, METRIC_LOGIN_PROFILE, METRIC_LOGIN_ACCOUNTS };
+		for (operationMetric phase : loginPhases)
+		{
+			operationHistogram(phase).reset();
+		}
+		latencyRecorder loadLoginLatency("loadLogin", _accounts);
+		for (const std::pair<std::string, std::string>& credential : credentials)
+		{
+			loginRecord login;
+			loadLoginLatency.time([&]() { loadLogin(login, store, credential.second, credential.first); });
+		}
+		loadLoginLatency.print();
+		for (operationMetric phase : loginPhases)
+		{
+			printPhase(phase, _accounts);
+		}
+
+		latencyRecorder savingExistanceLatency("savingExistance", _accounts);
+		latencyRecorder checkingExistanceLatency("checkingExistance", _accounts);
+		for (const customerHandle& user : users)
+		{
+			savingExistanceLatency.time([&]() { savingExistance(store, *user); });
+			checkingExistanceLatency.time([&]() { checkingExistance(store, *user); });
+		}
+		savingExistanceLatency.print();
+		checkingExistanceLatency.print();
+
+		// Signing up checks a username that is almost never taken, so time absent names as well as loaded ones
+		latencyRecorder takenUsernameLatency("userExistance(taken)", _accounts);
+		latencyRecorder freeUsernameLatency("userExistance(free)", _accounts);
+		for (size_t i = 0; i < users.size(); i++)
+		{
+			std::string freeUsername = "newuser" + std::to_string(i);
+			takenUsernameLatency.time([&]() { userExistance(store, users[i]->getusername()); });
+			freeUsernameLatency.time([&]() { userExistance(store, freeUsername); });
+		}
+		takenUsernameLatency.print();
+		freeUsernameLatency.print();
+		usernameFilterStats filterStats = store.getusernameFilterStats();
+		std::cout << "{\"metric\":\"usernameFilter\",\"accounts\":" << _accounts << ",\"lookups\":" << filterStats.lookups
+			<< ",\"definiteMisses\":" << filterStats.definiteMisses << ",\"falsePositives\":" << filterStats.falsePositives
+			<< ",\"falsePositiveRate\":" << filterStats.falsePositiveRate << ",\"expectedFalsePositiveRate\":" << filterStats.expectedFalsePositiveRate
+			<< ",\"filterBytes\":" << filterStats.filterBytes << "}\n";
+
+		latencyRecorder findByIdLatency("findSavingById", _accounts);
+		for (const customerHandle& user : users)
+		{
+			savingAccount userSaving;
+			if (store.findSaving(user->getusername(), userSaving))
+			{
+				int id = userSaving.getid();
+				findByIdLatency.time([&]() { store.findSavingById(id, userSaving); });
+			}
+		}
+		findByIdLatency.print();
+
+		latencyRecorder depositLatency("deposit+updateCheckingAccount", _accounts);
+		latencyRecorder interestLatency("accrueInterest+updateSavingAccount", _accounts);
+		for (const customerHandle& user : users)
+		{
+			checkingAccount userChecking;
+			savingAccount userSaving;
+			if (store.findChecking(user->getusername(), userChecking))
+			{
+				depositLatency.time([&]()
+					{
+						userChecking.deposit(money::fromCents(100));
+						updateCheckingAccount(userChecking, store);
+					});
+			}
+			if (store.findSaving(user->getusername(), userSaving))
+			{
+				interestLatency.time([&]()
+					{
+						// One day of interest, as the first write after a day without activity saves
+						userSaving.accrueInterest(userSaving.getaccrualDay() + 1);
+						updateSavingAccount(userSaving, store);
+					});
+			}
+		}
+		depositLatency.print();
+		interestLatency.print();
+
+		accountTable table;
+		store.fillTable(table);
+		latencyRecorder reportLatency("accountTable::report", _accounts);
+		reportLatency.time([&table]() { table.report(); });
+		reportLatency.print();
+
+		latencyRecorder postInterestLatency("postInterest", _accounts);
+		size_t paid = 0;
+		postInterestLatency.time([&]() { store.postInterest(std::max(1u, std::thread::hardware_concurrency()), paid); });
+		postInterestLatency.print();
+
+		latencyRecorder createSavingLatency("createSaving", _accounts);
+		latencyRecorder createCheckingLatency("createChecking", _accounts);
+		for (const customerHandle& user : users)
+		{
+			checkingAccount userChecking;
+			savingAccount userSaving;
+			if (savingExistance(store, *user) == false)
+			{
+				createSavingLatency.time([&]() { createSaving(store, user, store.allocateId(), userSaving); });
+			}
+			if (checkingExistance(store, *user) == false)
+			{
+				createCheckingLatency.time([&]() { createChecking(store, user, store.allocateId(), userChecking); });
+			}
+		}
+		createSavingLatency.print();
+		createCheckingLatency.print();
+
+		// Last, as it turns compaction off for the rest of the store's life
+		uint64_t allocations = depositAllocations(store, users);
+		std::cout << "{\"check\":\"depositAllocations\",\"accounts\":" << _accounts << ",\"allocations\":" << allocations << "}\n";
+		if (allocations > 0)
+		{
+			std::cout << "ERROR: deposit+updateCheckingAccount allocated " << allocations << " times\n";
+			return false;
+		}
+		return true;
+	}
+}
+
+#pragma region Benchmark Functions
+// runParserBenchmark function parses the same _lines account records with the old stringstream path and with recordParser
+// Both paths produce a checksum of every parsed field so the results can be compared
+void runParserBenchmark(size_t _lines)
+{
+	std::vector<std::string> lines = makeAccountLines(_lines);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	double checksum = 0;
+	for (const std::string& line : lines)
+	{
+		checksum += parseWithStringstream(line);
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	printResult("parser", "stringstream", lines.size(), elapsed.count(), checksum);
+
+	start = std::chrono::steady_clock::now();
+	checksum = 0;
+	for (const std::string& line : lines)
+	{
+		checksum += parseWithRecordParser(line);
+	}
+	elapsed = std::chrono::steady_clock::now() - start;
+	printResult("parser", "recordParser", lines.size(), elapsed.count(), checksum);
+}
+
+// runBenchmarkSuite function times loading, login (phase by phase and joined), the existence checks, account creation, deposits, interest accrual
+// end-of-day interest posting and the columnar report
+// at every dataset size, generating each dataset in _directory and removing it afterwards
+// Each result line carries throughput and p50/p99 latency so runs can be compared for regressions
+// Returns false if any size failed, such as by allocating on the deposit path
+bool runBenchmarkSuite(const std::vector<size_t>& _sizes, const std::string& _directory)
+{
+	std::error_code error;
+	std::filesystem::create_directories(_directory, error);
+	bool passed = true;
+	for (size_t accounts : _sizes)
+	{
+		passed = runDatasetBenchmarks(accounts, _directory) && passed;
+	}
+	std::filesystem::remove_all(_directory, error);
+	return passed;
+}
+#pragma endregion
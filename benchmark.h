@@ -0,0 +1,12 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Benchmark functions
+//
+// Run from the command line to time code paths without the interactive menus.
+// Results are printed one JSON object per line so they can be collected by scripts.
+// runBenchmarkSuite returns false if a dataset could not be generated or a deposit allocated, so scripts can fail on it.
+void runParserBenchmark(size_t _lines);
+bool runBenchmarkSuite(const std::vector<size_t>& _sizes, const std::string& _directory);
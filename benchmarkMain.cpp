@@ -0,0 +1,48 @@
+/*
+	Client Banking Interface benchmarks
+
+	Times the banking operations without the interactive menus. This executable is separate from the banking program
+	because benchmark.cpp replaces the global operator new to count heap allocations, and the banking program keeps
+	the default allocator.
+*/
+
+#include "benchmark.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+	/*
+		Command line options:
+			--parser [lines]: times the stringstream and recordParser account parsers (1000000 lines by default) and exits
+			[sizes ...]: times the banking operations on generated datasets (1000 100000 1000000 by default),
+				and exits with status 1 if a dataset could not be generated or a deposit allocated heap memory
+	*/
+
+	std::vector<size_t> sizes;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+		size_t size = 0;
+		if (option == "--parser")
+		{
+			size_t lines = 1000000;
+			if (i + 1 < argc)
+			{
+				std::stringstream(argv[i + 1]) >> lines;
+			}
+			runParserBenchmark(lines);
+			return 0;
+		}
+		else if (std::stringstream(option) >> size)
+		{
+			sizes.push_back(size);
+		}
+	}
+	if (sizes.empty())
+	{
+		sizes = { 1000, 100000, 1000000 };
+	}
+	return runBenchmarkSuite(sizes, "benchmarkData") ? 0 : 1;
+}
@@ -0,0 +1,563 @@
+#include "binaryAccountFile.h"
+#include "durableFile.h"
+#include "traceLog.h"
+#include "money.h"
+#include "recordParser.h"
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	const char fileMagic[4] = { 'C', 'B', 'I', 'A' };
+	const size_t initialCapacity = 1024;
+
+	// versionOneRecord: the slot layout of version 1 files, read only by upgradeFile
+	struct versionOneRecord
+	{
+		char type;
+		char username[63];
+		float balance;
+		float rate;
+		int32_t id;
+		int32_t depositCount;
+		int32_t withdrawalCount;
+		uint32_t reserved;
+	};
+
+	// lowerTo function lowers _value to _bound unless it already holds less, even while other threads change it
+	void lowerTo(std::atomic<size_t>& _value, size_t _bound)
+	{
+		size_t current = _value.load();
+		while (_bound < current && _value.compare_exchange_weak(current, _bound) == false)
+		{
+		}
+	}
+
+	// raiseTo function raises _value to _bound unless it already holds more, even while other threads change it
+	void raiseTo(std::atomic<size_t>& _value, size_t _bound)
+	{
+		size_t current = _value.load();
+		while (_bound > current && _value.compare_exchange_weak(current, _bound) == false)
+		{
+		}
+	}
+}
+
+#pragma region Binary Account File Class Implementation
+// Constructors, used for binary account file creation
+binaryAccountFile::binaryAccountFile()
+{
+	view = nullptr;
+	viewSize = 0;
+	capacity = 0;
+	syncWrites = true;
+	dirtyBegin = SIZE_MAX;
+	dirtyEnd = 0;
+	headerDirty = false;
+#ifdef _WIN32
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = nullptr;
+#else
+	fileDescriptor = -1;
+#endif
+}
+
+binaryAccountFile::~binaryAccountFile()
+{
+	close();
+}
+
+// Setters, used for setting specific private attributes
+void binaryAccountFile::setsyncWrites(bool _syncWrites)
+{
+	syncWrites = _syncWrites;
+}
+
+// Opening and closing
+
+// open function maps the file at _path, creating it with an empty header if it does not exist
+// Returns false if the file cannot be opened or was written by an incompatible version
+bool binaryAccountFile::open(const std::string& _path)
+{
+	close();
+	path = _path;
+
+	size_t fileSize = 0;
+#ifdef _WIN32
+	fileHandle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (GetFileSizeEx(fileHandle, &size) == FALSE)
+	{
+		close();
+		return false;
+	}
+	fileSize = static_cast<size_t>(size.QuadPart);
+#else
+	fileDescriptor = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (fileDescriptor < 0)
+	{
+		return false;
+	}
+	struct stat status;
+	if (fstat(fileDescriptor, &status) != 0)
+	{
+		close();
+		return false;
+	}
+	fileSize = static_cast<size_t>(status.st_size);
+#endif
+
+	bool created = fileSize < sizeof(binaryAccountHeader);
+	if (created)
+	{
+		fileSize = sizeof(binaryAccountHeader) + initialCapacity * sizeof(binaryAccountRecord);
+	}
+	if (map(fileSize) == false)
+	{
+		close();
+		return false;
+	}
+
+	if (created)
+	{
+		binaryAccountHeader* fileHeader = header();
+		std::memcpy(fileHeader->magic, fileMagic, sizeof(fileMagic));
+		fileHeader->version = currentVersion;
+		fileHeader->recordSize = sizeof(binaryAccountRecord);
+		fileHeader->reserved = 0;
+		fileHeader->recordCount = 0;
+		flush(0, sizeof(binaryAccountHeader));
+	}
+	else if (std::memcmp(header()->magic, fileMagic, sizeof(fileMagic)) != 0 || header()->version != currentVersion
+		|| header()->recordSize != sizeof(binaryAccountRecord) || header()->recordCount > capacity)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+// close function unmaps the file and releases the file handle
+void binaryAccountFile::close()
+{
+	unmap();
+	dirtyBegin = SIZE_MAX;
+	dirtyEnd = 0;
+	headerDirty = false;
+#ifdef _WIN32
+	if (fileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(fileHandle);
+		fileHandle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (fileDescriptor >= 0)
+	{
+		::close(fileDescriptor);
+		fileDescriptor = -1;
+	}
+#endif
+}
+
+bool binaryAccountFile::isOpen() const
+{
+	return view != nullptr;
+}
+
+// Records
+
+// getrecordCount function returns the number of used slots
+size_t binaryAccountFile::getrecordCount() const
+{
+	return isOpen() ? static_cast<size_t>(header()->recordCount) : 0;
+}
+
+// getrecord function returns the record in a used slot
+const binaryAccountRecord& binaryAccountFile::getrecord(size_t _slot) const
+{
+	return records()[_slot];
+}
+
+// update function overwrites a used slot in place and flushes the page holding it
+bool binaryAccountFile::update(size_t _slot, const binaryAccountRecord& _record)
+{
+	if (_slot >= getrecordCount())
+	{
+		return false;
+	}
+	records()[_slot] = _record;
+	return flush(sizeof(binaryAccountHeader) + _slot * sizeof(binaryAccountRecord), sizeof(binaryAccountRecord));
+}
+
+// append function writes a record to the next free slot, growing the file if it is full, and returns the slot in _slot
+// The record is flushed before the header count is raised, so a crash never exposes a partly written slot
+bool binaryAccountFile::append(const binaryAccountRecord& _record, size_t& _slot)
+{
+	if (isOpen() == false)
+	{
+		return false;
+	}
+
+	size_t count = getrecordCount();
+	if (count == capacity)
+	{
+		size_t grownSize = sizeof(binaryAccountHeader) + capacity * 2 * sizeof(binaryAccountRecord);
+		unmap();
+		if (map(grownSize) == false)
+		{
+			return false;
+		}
+	}
+
+	records()[count] = _record;
+	if (flush(sizeof(binaryAccountHeader) + count * sizeof(binaryAccountRecord), sizeof(binaryAccountRecord)) == false)
+	{
+		return false;
+	}
+	header()->recordCount = count + 1;
+	_slot = count;
+	return flush(0, sizeof(binaryAccountHeader));
+}
+
+// sync function flushes the header and the slots written since the last sync, used after writing with syncWrites turned off
+// It does not change syncWrites, so it can run while other threads update slots
+bool binaryAccountFile::sync()
+{
+	traceSpan span("flushMapping", "io");
+	if (isOpen() == false)
+	{
+		return false;
+	}
+	bool flushHeader = headerDirty.exchange(false);
+	size_t begin = dirtyBegin.exchange(SIZE_MAX);
+	size_t end = dirtyEnd.exchange(0);
+	if (flushHeader == false && begin >= end)
+	{
+		return true;
+	}
+	span.setargument("bytes", static_cast<int64_t>(begin < end ? end - begin : 0));
+
+	bool written = (flushHeader == false || writeBack(0, sizeof(binaryAccountHeader))) && (begin >= end || writeBack(begin, end - begin));
+#ifdef _WIN32
+	// FlushViewOfFile only hands the pages to the file system
+	written = written && FlushFileBuffers(fileHandle) != FALSE;
+#endif
+	if (written == false)
+	{
+		// Keep the range so the next sync retries it
+		markDirty(0, flushHeader ? sizeof(binaryAccountHeader) : 0);
+		markDirty(begin, begin < end ? end - begin : 0);
+	}
+	return written;
+}
+
+// Conversion
+
+// convertTextFile function streams userAccountData.txt, then its sealed log segment and then its log into a new binary
+// file and swaps it in for _binaryPath, replaying them as accountStore::load does, so the sealed segment is skipped once
+// the snapshot holds its generation
+// Only the username to slot map is held in memory, so datasets larger than memory can be converted while the text store stays live
+bool binaryAccountFile::convertTextFile(const std::string& _textPath, const std::string& _sealedPath, const std::string& _logPath, const std::string& _binaryPath)
+{
+	std::string newPath = _binaryPath + ".new";
+	std::remove(newPath.c_str());
+
+	binaryAccountFile output;
+	if (output.open(newPath) == false)
+	{
+		return false;
+	}
+	output.setsyncWrites(false);
+
+	std::unordered_map<std::string, size_t> slots;
+	uint64_t sealedGeneration = readSealedGeneration(_sealedPath);
+	bool replaySealed = sealedGeneration == 0 || sealedGeneration > readSnapshotGeneration(_textPath);
+	const std::string inputs[3] = { _textPath, replaySealed ? _sealedPath : std::string(), _logPath };
+	for (const std::string& input : inputs)
+	{
+		if (input.empty())
+		{
+			continue;
+		}
+		recordReader textData;
+		textData.open(input);
+		std::string_view line;
+		while (textData.nextLine(line))
+		{
+			accountLine account;
+			if (parseAccountLine(line, account) == false)
+			{
+				continue;
+			}
+
+			char type = 0;
+			if (account.type == "Saving")
+			{
+				type = 'S';
+			}
+			else if (account.type == "Checking")
+			{
+				type = 'C';
+			}
+			else
+			{
+				continue;
+			}
+
+			std::string usernameAccount(account.username);
+			binaryAccountRecord record;
+			int64_t rate = type == 'S' ? account.interestRate.getmillionths() : account.overdraftLimit.getcents();
+			if (makeRecord(type, usernameAccount, account.balance.getcents(), rate, account.id, account.depositCount, account.withdrawalCount, account.accrualDay, record) == false)
+			{
+				return false;
+			}
+
+			std::string key = type + usernameAccount;
+			std::unordered_map<std::string, size_t>::const_iterator existing = slots.find(key);
+			if (existing != slots.end())
+			{
+				output.update(existing->second, record);
+			}
+			else
+			{
+				size_t slot = 0;
+				if (output.append(record, slot) == false)
+				{
+					return false;
+				}
+				slots[key] = slot;
+			}
+		}
+		textData.close();
+	}
+
+	if (output.sync() == false)
+	{
+		return false;
+	}
+	output.close();
+
+	return replaceFile(newPath, _binaryPath) && syncDirectory(_binaryPath);
+}
+
+// upgradeFile function rewrites a version 1 file at _path in the current format, rounding its float balances to cents
+// and its rates to millionths (interest) or cents (overdraft limits). Files already in the current format are left alone
+// Returns false if an older file could not be read or rewritten
+bool binaryAccountFile::upgradeFile(const std::string& _path)
+{
+	std::ifstream oldFile(_path, std::ios::in | std::ios::binary);
+	binaryAccountHeader oldHeader;
+	if (oldFile.read(reinterpret_cast<char*>(&oldHeader), sizeof(oldHeader)).good() == false
+		|| std::memcmp(oldHeader.magic, fileMagic, sizeof(fileMagic)) != 0 || oldHeader.version != 1)
+	{
+		return true;
+	}
+	if (oldHeader.recordSize != sizeof(versionOneRecord))
+	{
+		return false;
+	}
+
+	std::string newPath = _path + ".new";
+	std::remove(newPath.c_str());
+	binaryAccountFile output;
+	if (output.open(newPath) == false)
+	{
+		return false;
+	}
+	output.setsyncWrites(false);
+
+	versionOneRecord oldRecord;
+	for (uint64_t slot = 0; slot < oldHeader.recordCount; slot++)
+	{
+		if (oldFile.read(reinterpret_cast<char*>(&oldRecord), sizeof(oldRecord)).good() == false)
+		{
+			return false;
+		}
+
+		int64_t rateScale = oldRecord.type == 'S' ? fixedRate::scale : money::scale;
+		binaryAccountRecord record;
+		std::memcpy(&record, &oldRecord, sizeof(record.type) + sizeof(record.username));
+		record.balance = std::llround(static_cast<double>(oldRecord.balance) * money::scale);
+		record.rate = std::llround(static_cast<double>(oldRecord.rate) * rateScale);
+		record.id = oldRecord.id;
+		record.depositCount = oldRecord.depositCount;
+		record.withdrawalCount = oldRecord.withdrawalCount;
+		record.accrualDay = 0;
+
+		size_t newSlot = 0;
+		if (output.append(record, newSlot) == false)
+		{
+			return false;
+		}
+	}
+	oldFile.close();
+
+	if (output.sync() == false)
+	{
+		return false;
+	}
+	output.close();
+
+	return replaceFile(newPath, _path) && syncDirectory(_path);
+}
+
+// makeRecord function fills a fixed-size record, returning false if the username does not fit in its slot
+bool binaryAccountFile::makeRecord(char _type, const std::string& _username, int64_t _balance, int64_t _rate, int _id, int _depositCount, int _withdrawalCount, int64_t _accrualDay, binaryAccountRecord& _record)
+{
+	if (_username.size() > sizeof(_record.username))
+	{
+		return false;
+	}
+
+	std::memset(&_record, 0, sizeof(_record));
+	_record.type = _type;
+	std::memcpy(_record.username, _username.data(), _username.size());
+	_record.balance = _balance;
+	_record.rate = _rate;
+	_record.id = _id;
+	_record.depositCount = _depositCount;
+	_record.withdrawalCount = _withdrawalCount;
+	_record.accrualDay = static_cast<uint32_t>(_accrualDay);
+	return true;
+}
+
+// getusername function returns the username key of a record, which is only NUL terminated when shorter than its slot
+std::string binaryAccountFile::getusername(const binaryAccountRecord& _record)
+{
+	size_t length = 0;
+	while (length < sizeof(_record.username) && _record.username[length] != '\0')
+	{
+		length++;
+	}
+	return std::string(_record.username, length);
+}
+
+// Mapping helpers
+
+// map function sizes the file to _fileSize bytes and maps all of it
+bool binaryAccountFile::map(size_t _fileSize)
+{
+#ifdef _WIN32
+	ULARGE_INTEGER size;
+	size.QuadPart = _fileSize;
+	mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);
+	if (mappingHandle == nullptr)
+	{
+		return false;
+	}
+	view = static_cast<char*>(MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, _fileSize));
+	if (view == nullptr)
+	{
+		CloseHandle(mappingHandle);
+		mappingHandle = nullptr;
+		return false;
+	}
+#else
+	struct stat status;
+	if (fstat(fileDescriptor, &status) != 0)
+	{
+		return false;
+	}
+	if (static_cast<size_t>(status.st_size) < _fileSize && ftruncate(fileDescriptor, static_cast<off_t>(_fileSize)) != 0)
+	{
+		return false;
+	}
+	void* address = mmap(nullptr, _fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+	if (address == MAP_FAILED)
+	{
+		return false;
+	}
+	view = static_cast<char*>(address);
+#endif
+	viewSize = _fileSize;
+	capacity = (_fileSize - sizeof(binaryAccountHeader)) / sizeof(binaryAccountRecord);
+	return true;
+}
+
+// unmap function releases the current mapping, leaving the file open
+void binaryAccountFile::unmap()
+{
+	if (view == nullptr)
+	{
+		return;
+	}
+#ifdef _WIN32
+	UnmapViewOfFile(view);
+	CloseHandle(mappingHandle);
+	mappingHandle = nullptr;
+#else
+	munmap(view, viewSize);
+#endif
+	view = nullptr;
+	viewSize = 0;
+	capacity = 0;
+}
+
+// flush function writes the pages covering [_offset, _offset + _length) back to the file when syncWrites is on,
+// and otherwise leaves them for the next sync
+bool binaryAccountFile::flush(size_t _offset, size_t _length)
+{
+	if (syncWrites == false)
+	{
+		markDirty(_offset, _length);
+		return true;
+	}
+	return writeBack(_offset, _length);
+}
+
+// writeBack function writes the pages covering [_offset, _offset + _length) back to the file
+bool binaryAccountFile::writeBack(size_t _offset, size_t _length)
+{
+#ifdef _WIN32
+	return FlushViewOfFile(view + _offset, _length) != FALSE;
+#else
+	size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	size_t start = _offset - (_offset % pageSize);
+	return msync(view + start, _offset + _length - start, MS_SYNC) == 0;
+#endif
+}
+
+// markDirty function adds [_offset, _offset + _length) to the range the next sync flushes; offset 0 is the header
+void binaryAccountFile::markDirty(size_t _offset, size_t _length)
+{
+	if (_length == 0)
+	{
+		return;
+	}
+	if (_offset == 0)
+	{
+		headerDirty = true;
+		return;
+	}
+	lowerTo(dirtyBegin, _offset);
+	raiseTo(dirtyEnd, _offset + _length);
+}
+
+binaryAccountHeader* binaryAccountFile::header() const
+{
+	return reinterpret_cast<binaryAccountHeader*>(view);
+}
+
+binaryAccountRecord* binaryAccountFile::records() const
+{
+	return reinterpret_cast<binaryAccountRecord*>(view + sizeof(binaryAccountHeader));
+}
+#pragma endregion
@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// binaryAccountHeader: first bytes of a binary account file
+struct binaryAccountHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t recordSize;
+	uint32_t reserved;
+	uint64_t recordCount;
+};
+
+// binaryAccountRecord: one fixed-size account slot
+// type is 'S' for Saving or 'C' for Checking, balance is in cents
+// and rate holds the interest rate in millionths or the overdraft limit in cents
+// accrualDay is the day a Saving account last accrued interest, or 0 if it never has; files that predate it hold 0 there
+struct binaryAccountRecord
+{
+	char type;
+	char username[63];
+	int64_t balance;
+	int64_t rate;
+	int32_t id;
+	int32_t depositCount;
+	int32_t withdrawalCount;
+	uint32_t accrualDay;
+};
+
+// BinaryAccountFile class declaration
+//
+// Memory-maps a file of fixed-size account records so that changing one account is a single in-place
+// store into the mapping followed by a flush of the touched page, instead of a parse and rewrite of the whole file.
+// With syncWrites off it records the slots written since the last sync, so sync flushes only those pages.
+class binaryAccountFile
+{
+public:
+	// Constructors
+	binaryAccountFile();
+	~binaryAccountFile();
+	binaryAccountFile(const binaryAccountFile&) = delete;
+	binaryAccountFile& operator=(const binaryAccountFile&) = delete;
+
+	// Setters
+	void setsyncWrites(bool _syncWrites);
+
+	// Opening and closing
+	bool open(const std::string& _path);
+	void close();
+	bool isOpen() const;
+
+	// Records
+	size_t getrecordCount() const;
+	const binaryAccountRecord& getrecord(size_t _slot) const;
+	bool update(size_t _slot, const binaryAccountRecord& _record);
+	bool append(const binaryAccountRecord& _record, size_t& _slot);
+	bool sync();
+
+	// Conversion
+	static bool convertTextFile(const std::string& _textPath, const std::string& _sealedPath, const std::string& _logPath, const std::string& _binaryPath);
+	static bool upgradeFile(const std::string& _path);
+	static bool makeRecord(char _type, const std::string& _username, int64_t _balance, int64_t _rate, int _id, int _depositCount, int _withdrawalCount, int64_t _accrualDay, binaryAccountRecord& _record);
+	static std::string getusername(const binaryAccountRecord& _record);
+
+	// Version 1 held float balances and rates; version 2 holds cents and millionths
+	static const uint32_t currentVersion = 2;
+
+private:
+	bool map(size_t _fileSize);
+	void unmap();
+	bool flush(size_t _offset, size_t _length);
+	bool writeBack(size_t _offset, size_t _length);
+	void markDirty(size_t _offset, size_t _length);
+	binaryAccountHeader* header() const;
+	binaryAccountRecord* records() const;
+
+	// Attributes
+	std::string path;
+	char* view;
+	size_t viewSize;
+	size_t capacity;
+	bool syncWrites;
+	// The byte range of slots written since the last sync, empty when dirtyBegin >= dirtyEnd; updates from several
+	// threads can widen it at once
+	std::atomic<size_t> dirtyBegin;
+	std::atomic<size_t> dirtyEnd;
+	std::atomic<bool> headerDirty;
+#ifdef _WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#else
+	int fileDescriptor;
+#endif
+};
@@ -0,0 +1,104 @@
+#include "bloomFilter.h"
+#include <cmath>
+#include <functional>
+
+namespace
+{
+	const uint64_t wordBits = 64;
+
+	// mix function scrambles a hash into a second, independent looking one (the splitmix64 finalizer)
+	uint64_t mix(uint64_t _hash)
+	{
+		_hash ^= _hash >> 30;
+		_hash *= 0xBF58476D1CE4E5B9ull;
+		_hash ^= _hash >> 27;
+		_hash *= 0x94D049BB133111EBull;
+		_hash ^= _hash >> 31;
+		return _hash;
+	}
+}
+
+#pragma region Bloom Filter Class Implementation
+// Constructors, used for bloom filter creation
+// An empty filter holds one word and answers "definitely absent" for every key
+bloomFilter::bloomFilter()
+{
+	reset(0);
+}
+
+// Keys
+
+// reset function empties the filter and sizes it for _capacity keys, rounding the bit count up to a power of 2
+void bloomFilter::reset(size_t _capacity)
+{
+	uint64_t bitCount = wordBits;
+	while (bitCount < _capacity * bitsPerItem)
+	{
+		bitCount <<= 1;
+	}
+	bits.assign(bitCount / wordBits, 0);
+	bits.shrink_to_fit();
+	mask = bitCount - 1;
+	capacity = _capacity;
+	itemCount = 0;
+}
+
+void bloomFilter::add(std::string_view _key)
+{
+	uint64_t first = mix(std::hash<std::string_view>()(_key));
+	// An odd step visits hashCount different bits of a power of 2 sized array
+	uint64_t step = mix(first) | 1;
+	for (int i = 0; i < hashCount; i++)
+	{
+		uint64_t bit = (first + i * step) & mask;
+		bits[bit / wordBits] |= uint64_t(1) << (bit % wordBits);
+	}
+	itemCount++;
+}
+
+// mightContain function returns false only if the key was never added
+bool bloomFilter::mightContain(std::string_view _key) const
+{
+	uint64_t first = mix(std::hash<std::string_view>()(_key));
+	uint64_t step = mix(first) | 1;
+	for (int i = 0; i < hashCount; i++)
+	{
+		uint64_t bit = (first + i * step) & mask;
+		if ((bits[bit / wordBits] >> (bit % wordBits) & 1) == 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// isFull function is true once the filter holds as many keys as it was sized for
+bool bloomFilter::isFull() const
+{
+	return itemCount >= capacity;
+}
+
+// Getters, used for returning private attributes
+size_t bloomFilter::getcapacity() const
+{
+	return capacity;
+}
+
+size_t bloomFilter::getitemCount() const
+{
+	return itemCount;
+}
+
+size_t bloomFilter::getbyteCount() const
+{
+	return bits.size() * sizeof(uint64_t);
+}
+
+// getexpectedFalsePositiveRate function returns the chance an absent key looks present at the current fill,
+// (1 - e^(-k n / m))^k for k hashes, n keys and m bits
+double bloomFilter::getexpectedFalsePositiveRate() const
+{
+	double bitCount = static_cast<double>(mask) + 1;
+	return std::pow(1 - std::exp(-hashCount * static_cast<double>(itemCount) / bitCount), hashCount);
+}
+#pragma endregion
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// BloomFilter class declaration
+//
+// A set of keys that answers "definitely absent" or "maybe present" from a bit array, without storing the keys.
+// Each key sets hashCount bits chosen by double hashing one 64 bit hash. With bitsPerItem bits per key the chance that
+// an absent key looks present stays under 1% until the filter holds its capacity, after which the owner rebuilds it
+// larger from the keys it keeps elsewhere.
+class bloomFilter
+{
+public:
+	// Constructors
+	bloomFilter();
+
+	// Keys
+	void reset(size_t _capacity);
+	void add(std::string_view _key);
+	bool mightContain(std::string_view _key) const;
+	bool isFull() const;
+
+	// Getters
+	size_t getcapacity() const;
+	size_t getitemCount() const;
+	size_t getbyteCount() const;
+	double getexpectedFalsePositiveRate() const;
+
+	static const size_t bitsPerItem = 10;
+	static const int hashCount = 7;
+
+private:
+	// Attributes
+	std::vector<uint64_t> bits;
+	uint64_t mask;
+	size_t capacity;
+	size_t itemCount;
+};
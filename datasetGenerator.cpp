@@ -0,0 +1,374 @@
+#include "datasetGenerator.h"
+#include "accountIdAllocator.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	const size_t chunkSize = 1 << 16;
+	const char* const firstNames[] = { "James", "Mary", "Robert", "Patricia", "John", "Jennifer", "Michael", "Linda" };
+	const char* const lastNames[] = { "Smith", "Johnson", "Williams", "Brown", "Jones", "Garcia", "Miller", "Davis" };
+	const char* const streets[] = { "Main St", "Oak Ave", "Pine Rd", "Maple Dr", "Cedar Ln", "Elm St" };
+
+	// mix function is the splitmix64 finalizer, used so every value depends only on the seed and a counter
+	uint64_t mix(uint64_t _value)
+	{
+		_value += 0x9E3779B97F4A7C15ull;
+		_value = (_value ^ (_value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		_value = (_value ^ (_value >> 27)) * 0x94D049BB133111EBull;
+		return _value ^ (_value >> 31);
+	}
+
+	// randomStream: a splitmix64 sequence seeded from the dataset seed and a stream number
+	struct randomStream
+	{
+		uint64_t state;
+
+		randomStream(uint64_t _seed, uint64_t _stream)
+		{
+			state = mix(_seed ^ mix(_stream));
+		}
+
+		uint64_t next()
+		{
+			state += 0x9E3779B97F4A7C15ull;
+			return mix(state);
+		}
+
+		uint64_t below(uint64_t _bound)
+		{
+			return next() % _bound;
+		}
+	};
+
+	bool hasSaving(const generatorOptions& _options, size_t _customer)
+	{
+		return mix(_options.seed ^ (_customer * 2 + 1)) % 100 < _options.savingPercent;
+	}
+
+	bool hasChecking(const generatorOptions& _options, size_t _customer)
+	{
+		return mix(_options.seed ^ (_customer * 2 + 2)) % 100 < _options.checkingPercent;
+	}
+
+	// accountIdBase function returns the first account id of a dataset of _customers customers: the smallest power of ten,
+	// from accountIdAllocator::firstId up, that leaves room for two ids per customer within the same number of digits,
+	// so generated ids are as wide as the ones the allocator hands out once that many accounts exist
+	// Returns 0 if the customers need wider ids than the account files hold
+	uint64_t accountIdBase(size_t _customers)
+	{
+		uint64_t base = accountIdAllocator::firstId;
+		for (int width = accountIdAllocator::firstWidth; width <= accountIdAllocator::maxWidth; width++)
+		{
+			if (static_cast<uint64_t>(_customers) * 2 <= base * 9)
+			{
+				return base;
+			}
+			base *= 10;
+		}
+		return 0;
+	}
+
+	// hasAccount function returns true if the customer has a saving or a checking account
+	bool hasAccount(const generatorOptions& _options, size_t _customer)
+	{
+		return hasSaving(_options, _customer) || hasChecking(_options, _customer);
+	}
+
+	void appendNumber(std::string& _out, uint64_t _value)
+	{
+		char digits[24];
+		std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), _value);
+		_out.append(digits, result.ptr);
+	}
+
+	// appendCents function writes an amount in cents as dollars with two decimals
+	void appendCents(std::string& _out, int64_t _cents)
+	{
+		if (_cents < 0)
+		{
+			_out += '-';
+			_cents = -_cents;
+		}
+		appendNumber(_out, static_cast<uint64_t>(_cents / 100));
+		_out += '.';
+		_out += static_cast<char>('0' + (_cents % 100) / 10);
+		_out += static_cast<char>('0' + _cents % 10);
+	}
+
+	void appendUsername(std::string& _out, size_t _customer)
+	{
+		_out += "user";
+		appendNumber(_out, _customer);
+	}
+
+	// writeUsers function formats the profiles of one chunk of customers, with passwords that meet inputPasswd's rules
+	void writeUsers(const generatorOptions& _options, size_t _chunk, std::string& _out)
+	{
+		randomStream random(_options.seed, _chunk * 3);
+		size_t end = std::min(_options.customers, (_chunk + 1) * chunkSize);
+		for (size_t customer = _chunk * chunkSize; customer < end; customer++)
+		{
+			appendUsername(_out, customer);
+			_out += ':';
+			_out += firstNames[random.below(8)];
+			_out += ':';
+			_out += lastNames[random.below(8)];
+			_out += ':';
+			appendNumber(_out, 1 + random.below(9999));
+			_out += ' ';
+			_out += streets[random.below(6)];
+			_out += ":555-";
+			appendNumber(_out, 1000 + random.below(9000));
+			_out += ':';
+			appendUsername(_out, customer);
+			_out += "@example.com:Aa1!";
+			for (int i = 0; i < 6; i++)
+			{
+				_out += static_cast<char>('a' + random.below(26));
+			}
+			_out += ":\n";
+		}
+	}
+
+	// writeAccounts function formats the saving and checking accounts of one chunk of customers
+	// Account ids are accountIdBase + 2 * customer for saving and one more for checking, so they never collide
+	void writeAccounts(const generatorOptions& _options, size_t _chunk, std::string& _out)
+	{
+		randomStream random(_options.seed, _chunk * 3 + 1);
+		uint64_t idBase = accountIdBase(_options.customers);
+		size_t end = std::min(_options.customers, (_chunk + 1) * chunkSize);
+		for (size_t customer = _chunk * chunkSize; customer < end; customer++)
+		{
+			if (hasSaving(_options, customer))
+			{
+				_out += "Saving:";
+				appendUsername(_out, customer);
+				_out += ':';
+				appendCents(_out, static_cast<int64_t>(random.below(1000000)));
+				_out += ":0.05:";
+				appendNumber(_out, idBase + customer * 2);
+				_out += ':';
+				appendNumber(_out, random.below(50));
+				_out += ':';
+				appendNumber(_out, random.below(50));
+				_out += ":\n";
+			}
+			if (hasChecking(_options, customer))
+			{
+				_out += "Checking:";
+				appendUsername(_out, customer);
+				_out += ':';
+				appendCents(_out, static_cast<int64_t>(random.below(500000)));
+				_out += ":25:";
+				appendNumber(_out, idBase + customer * 2 + 1);
+				_out += ':';
+				appendNumber(_out, random.below(50));
+				_out += ':';
+				appendNumber(_out, random.below(50));
+				_out += ":\n";
+			}
+		}
+	}
+
+	// writeTransactions function formats one chunk of transactions for runBatch
+	// hotPercent of them go to the first hotUsers customers; deposits and withdrawals are split 60/40
+	// A transaction drawn for a customer without accounts goes to the next customer that has one; if no customer has an
+	// account there is nothing to transact on and the chunk stays empty
+	void writeTransactions(const generatorOptions& _options, size_t _chunk, std::string& _out)
+	{
+		randomStream random(_options.seed, _chunk * 3 + 2);
+		size_t end = std::min(_options.transactions, (_chunk + 1) * chunkSize);
+		size_t hotUsers = std::min(std::max<size_t>(_options.hotUsers, 1), _options.customers);
+		for (size_t transaction = _chunk * chunkSize; transaction < end; transaction++)
+		{
+			size_t customer = 0;
+			if (random.below(100) < _options.hotPercent)
+			{
+				customer = random.below(hotUsers);
+			}
+			else
+			{
+				customer = random.below(_options.customers);
+			}
+			size_t skipped = 0;
+			while (hasAccount(_options, customer) == false && skipped < _options.customers)
+			{
+				customer = (customer + 1) % _options.customers;
+				skipped++;
+			}
+			if (skipped == _options.customers)
+			{
+				return;
+			}
+
+			bool saving = hasSaving(_options, customer);
+			bool checking = hasChecking(_options, customer);
+			if (saving && checking)
+			{
+				saving = random.below(2) == 0;
+			}
+
+			appendUsername(_out, customer);
+			_out += saving ? ":Saving:" : ":Checking:";
+			int64_t cents = 1 + static_cast<int64_t>(random.below(50000));
+			appendCents(_out, random.below(10) < 6 ? cents : -cents);
+			_out += ":\n";
+		}
+	}
+
+	// writeParallel function produces _chunks chunks on _threads threads and writes them to _path in order
+	// Threads format one round of chunks at a time, so memory stays at one chunk per thread
+	bool writeParallel(const std::string& _path, size_t _chunks, unsigned _threads, const std::function<void(size_t, std::string&)>& _produce)
+	{
+		std::ofstream file(_path, std::ios::out | std::ios::trunc | std::ios::binary);
+		if (file.is_open() == false)
+		{
+			return false;
+		}
+
+		std::vector<std::string> buffers(_threads);
+		for (size_t round = 0; round < _chunks; round += _threads)
+		{
+			std::vector<std::thread> workers;
+			for (unsigned worker = 0; worker < _threads && round + worker < _chunks; worker++)
+			{
+				workers.emplace_back([&buffers, &_produce, round, worker]()
+					{
+						buffers[worker].clear();
+						_produce(round + worker, buffers[worker]);
+					});
+			}
+			for (size_t worker = 0; worker < workers.size(); worker++)
+			{
+				workers[worker].join();
+				file.write(buffers[worker].data(), static_cast<std::streamsize>(buffers[worker].size()));
+			}
+		}
+		file.close();
+		return file.good();
+	}
+}
+
+#pragma region Dataset Generation Functions
+// defaultGeneratorOptions function returns options for 1000 customers with most holding both account types
+generatorOptions defaultGeneratorOptions()
+{
+	generatorOptions options;
+	options.customers = 1000;
+	options.savingPercent = 60;
+	options.checkingPercent = 80;
+	options.transactions = 0;
+	options.hotUsers = 10;
+	options.hotPercent = 50;
+	options.threads = std::max(1u, std::thread::hardware_concurrency());
+	options.seed = 1;
+	options.userDataPath = "userData.txt";
+	options.userAccountDataPath = "userAccountData.txt";
+	options.userAccountLogPath = "userAccountLog.txt";
+	options.binaryPath = "userAccountData.bin";
+	options.ledgerPath = "userLedger";
+	options.transactionPath = "transactions.txt";
+	return options;
+}
+
+// parseGeneratorOption function applies one key=value command line option, returning false if it is not recognised
+// Keys are customers, saving, checking, transactions, hot, hotshare, threads, seed and out (the transaction file)
+bool parseGeneratorOption(const std::string& _option, generatorOptions& _options)
+{
+	size_t separator = _option.find('=');
+	if (separator == std::string::npos)
+	{
+		return false;
+	}
+	std::string key = _option.substr(0, separator);
+	std::stringstream value(_option.substr(separator + 1));
+
+	if (key == "customers")
+	{
+		value >> _options.customers;
+	}
+	else if (key == "saving")
+	{
+		value >> _options.savingPercent;
+	}
+	else if (key == "checking")
+	{
+		value >> _options.checkingPercent;
+	}
+	else if (key == "transactions")
+	{
+		value >> _options.transactions;
+	}
+	else if (key == "hot")
+	{
+		value >> _options.hotUsers;
+	}
+	else if (key == "hotshare")
+	{
+		value >> _options.hotPercent;
+	}
+	else if (key == "threads")
+	{
+		value >> _options.threads;
+	}
+	else if (key == "seed")
+	{
+		value >> _options.seed;
+	}
+	else if (key == "out")
+	{
+		_options.transactionPath = value.str();
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+	return value.fail() == false;
+}
+
+// generateDataset function writes the profile, account and transaction files described by _options
+// Any account log, sealed log segment, binary account file or ledger is removed so that it is not replayed over the new accounts
+// Returns false if a file could not be written or there are too many customers for the account ids
+bool generateDataset(const generatorOptions& _options)
+{
+	if (accountIdBase(_options.customers) == 0)
+	{
+		return false;
+	}
+	std::remove(_options.userAccountLogPath.c_str());
+	std::remove((_options.userAccountLogPath + ".sealed").c_str());
+	std::remove(_options.binaryPath.c_str());
+	std::remove((_options.ledgerPath + ".journal").c_str());
+	std::remove((_options.ledgerPath + ".blocks").c_str());
+
+	unsigned threads = std::max(1u, _options.threads);
+	size_t customerChunks = (_options.customers + chunkSize - 1) / chunkSize;
+	size_t transactionChunks = (_options.transactions + chunkSize - 1) / chunkSize;
+
+	if (writeParallel(_options.userDataPath, customerChunks, threads,
+		[&_options](size_t _chunk, std::string& _out) { writeUsers(_options, _chunk, _out); }) == false)
+	{
+		return false;
+	}
+	if (writeParallel(_options.userAccountDataPath, customerChunks, threads,
+		[&_options](size_t _chunk, std::string& _out) { writeAccounts(_options, _chunk, _out); }) == false)
+	{
+		return false;
+	}
+	if (_options.transactions > 0 && _options.customers > 0)
+	{
+		return writeParallel(_options.transactionPath, transactionChunks, threads,
+			[&_options](size_t _chunk, std::string& _out) { writeTransactions(_options, _chunk, _out); });
+	}
+	return true;
+}
+#pragma endregion
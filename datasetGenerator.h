@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// generatorOptions: what generateDataset writes
+//
+// savingPercent and checkingPercent are the share of customers that get each account type.
+// Of the transactions, hotPercent go to the first hotUsers customers and the rest are spread over everyone.
+struct generatorOptions
+{
+	size_t customers;
+	unsigned savingPercent;
+	unsigned checkingPercent;
+	size_t transactions;
+	size_t hotUsers;
+	unsigned hotPercent;
+	unsigned threads;
+	uint64_t seed;
+	std::string userDataPath;
+	std::string userAccountDataPath;
+	std::string userAccountLogPath;
+	std::string binaryPath;
+	std::string ledgerPath;
+	std::string transactionPath;
+};
+
+// Dataset generation functions
+//
+// Writes synthetic userData.txt and userAccountData.txt files in the same format as signUp, createSaving and createChecking,
+// and optionally a transaction file for runBatch. Every customer's records depend only on the seed and the customer number,
+// so the output is identical for any thread count. The ledger files at ledgerPath are removed, as new accounts have no history.
+generatorOptions defaultGeneratorOptions();
+bool parseGeneratorOption(const std::string& _option, generatorOptions& _options);
+bool generateDataset(const generatorOptions& _options);
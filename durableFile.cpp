@@ -0,0 +1,64 @@
+#include "durableFile.h"
+#include "traceLog.h"
+#include <cstdio>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#pragma region Durable File Functions
+bool syncFile(const std::string& _path)
+{
+	traceSpan span("fsync", "io");
+#ifdef _WIN32
+	HANDLE file = CreateFileA(_path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return GetLastError() == ERROR_FILE_NOT_FOUND;
+	}
+	bool flushed = FlushFileBuffers(file) != FALSE;
+	CloseHandle(file);
+	return flushed;
+#else
+	int fileDescriptor = ::open(_path.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		return errno == ENOENT;
+	}
+	bool flushed = fsync(fileDescriptor) == 0;
+	::close(fileDescriptor);
+	return flushed;
+#endif
+}
+
+// Windows cannot open a directory to flush it, so there this does nothing
+bool syncDirectory(const std::string& _path)
+{
+	traceSpan span("fsyncDirectory", "io");
+#ifdef _WIN32
+	(void)_path;
+	return true;
+#else
+	size_t separator = _path.find_last_of('/');
+	return syncFile(separator == std::string::npos ? "." : (separator == 0 ? "/" : _path.substr(0, separator)));
+#endif
+}
+
+// On POSIX systems rename already replaces the target atomically; on Windows it fails if the target exists
+bool replaceFile(const std::string& _from, const std::string& _to)
+{
+	traceSpan span("rename", "io");
+#ifdef _WIN32
+	return MoveFileExA(_from.c_str(), _to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE;
+#else
+	return std::rename(_from.c_str(), _to.c_str()) == 0;
+#endif
+}
+#pragma endregion
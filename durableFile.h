@@ -0,0 +1,11 @@
+#pragma once
+#include <string>
+
+// Durable file functions
+//
+// syncFile forces a file's written data to disk, as fsync does; it succeeds if the file does not exist.
+// syncDirectory does the same for the directory holding _path, so a rename into it survives a crash.
+// replaceFile renames _from over _to in one step, so a crash leaves either the old or the new file and never neither.
+bool syncFile(const std::string& _path);
+bool syncDirectory(const std::string& _path);
+bool replaceFile(const std::string& _from, const std::string& _to);
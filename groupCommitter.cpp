@@ -0,0 +1,105 @@
+#include "groupCommitter.h"
+#include <limits>
+
+#pragma region Group Committer Class Implementation
+// Constructors, used for group committer creation
+// The background thread is started by the first commit, so stores that never write do not start one
+groupCommitter::groupCommitter(std::function<bool()> _sync) : sync(std::move(_sync))
+{
+	maxDelay = std::chrono::microseconds(0);
+	requested = 0;
+	durable = 0;
+	failedFrom = std::numeric_limits<uint64_t>::max();
+	syncCount = 0;
+	stopping = false;
+}
+
+// Destructor finishes the commits already requested before stopping the background thread
+groupCommitter::~groupCommitter()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	pending.notify_one();
+	if (flusher.joinable())
+	{
+		flusher.join();
+	}
+}
+
+// Setters, used for setting specific private attributes
+void groupCommitter::setmaxDelay(std::chrono::microseconds _maxDelay)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	maxDelay = _maxDelay;
+}
+
+// Committing
+
+// commit function returns once everything the calling thread wrote before the call is on disk
+// Returns false if the sync covering it, or an earlier one, failed
+bool groupCommitter::commit()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (flusher.joinable() == false)
+	{
+		flusher = std::thread(&groupCommitter::run, this);
+	}
+	uint64_t ticket = ++requested;
+	pending.notify_one();
+	synced.wait(lock, [this, ticket]() { return durable >= ticket; });
+	return ticket < failedFrom;
+}
+
+// run function is the background thread: it waits for commits, gathers them for up to maxDelay and syncs them together
+void groupCommitter::run()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		pending.wait(lock, [this]() { return stopping || requested > durable; });
+		if (requested == durable)
+		{
+			return;
+		}
+		// A lone writer is synced at once; the delay only pays off when others are already queued behind it
+		if (stopping == false && maxDelay.count() > 0 && requested - durable > 1)
+		{
+			pending.wait_for(lock, maxDelay, [this]() { return stopping; });
+		}
+
+		uint64_t target = requested;
+		lock.unlock();
+		bool succeeded = sync();
+		lock.lock();
+
+		if (succeeded == false && failedFrom > durable)
+		{
+			failedFrom = durable + 1;
+		}
+		durable = target;
+		syncCount++;
+		synced.notify_all();
+	}
+}
+
+// Getters, used for returning private attributes
+std::chrono::microseconds groupCommitter::getmaxDelay() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return maxDelay;
+}
+
+uint64_t groupCommitter::getcommitCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return requested;
+}
+
+uint64_t groupCommitter::getsyncCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return syncCount;
+}
+#pragma endregion
@@ -0,0 +1,54 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// GroupCommitter class declaration
+//
+// Makes writes durable in groups instead of one fsync per write. A thread that has written its change calls commit(),
+// which blocks until a run of the sync function that started after the write has finished. A background thread runs
+// the sync function for every commit requested so far, so every write that arrives while one fsync runs shares the next.
+// On disks where an fsync is slow, maxDelay makes the thread also wait that long whenever several commits are already
+// queued, to gather more writers into the same fsync. It is 0 by default.
+//
+// If a sync fails, that commit and every later one return false, since the files can no longer be trusted to hold them.
+class groupCommitter
+{
+public:
+	// Constructors
+	groupCommitter(std::function<bool()> _sync);
+	~groupCommitter();
+	groupCommitter(const groupCommitter&) = delete;
+	groupCommitter& operator=(const groupCommitter&) = delete;
+
+	// Setters
+	void setmaxDelay(std::chrono::microseconds _maxDelay);
+
+	// Committing
+	bool commit();
+
+	// Getters
+	std::chrono::microseconds getmaxDelay() const;
+	uint64_t getcommitCount() const;
+	uint64_t getsyncCount() const;
+
+private:
+	void run();
+
+	// Attributes
+	std::function<bool()> sync;
+	std::chrono::microseconds maxDelay;
+	uint64_t requested;
+	uint64_t durable;
+	uint64_t failedFrom;
+	uint64_t syncCount;
+	bool stopping;
+	mutable std::mutex mutex;
+	std::condition_variable pending;
+	std::condition_variable synced;
+	std::thread flusher;
+};
+
@@ -0,0 +1,84 @@
+#include "money.h"
+#include <charconv>
+
+namespace
+{
+	// writeFixed function writes _units / _scale as a decimal number with _decimals digits after the point,
+	// dropping trailing zeros (and the point) unless _keepZeros is set
+	char* writeFixed(char* _first, char* _last, int64_t _units, int64_t _scale, int _decimals, bool _keepZeros)
+	{
+		uint64_t magnitude = _units < 0 ? 0 - static_cast<uint64_t>(_units) : static_cast<uint64_t>(_units);
+		if (_units < 0 && _first < _last)
+		{
+			*_first++ = '-';
+		}
+		_first = std::to_chars(_first, _last, magnitude / static_cast<uint64_t>(_scale)).ptr;
+
+		uint64_t fraction = magnitude % static_cast<uint64_t>(_scale);
+		if (fraction == 0 && _keepZeros == false)
+		{
+			return _first;
+		}
+
+		char digits[20];
+		for (int digit = _decimals - 1; digit >= 0; digit--)
+		{
+			digits[digit] = static_cast<char>('0' + fraction % 10);
+			fraction /= 10;
+		}
+		int length = _decimals;
+		while (_keepZeros == false && length > 0 && digits[length - 1] == '0')
+		{
+			length--;
+		}
+		if (_last - _first < length + 1)
+		{
+			return _first;
+		}
+		*_first++ = '.';
+		for (int digit = 0; digit < length; digit++)
+		{
+			*_first++ = digits[digit];
+		}
+		return _first;
+	}
+}
+
+#pragma region Fixed Rate Class Implementation
+// toChars function writes the rate with up to six decimals and no trailing zeros, as 0.05 for 50000 millionths
+char* fixedRate::toChars(char* _first, char* _last) const
+{
+	return writeFixed(_first, _last, millionths, scale, 6, false);
+}
+#pragma endregion
+
+#pragma region Money Class Implementation
+// operator* function returns the amount multiplied by a rate, rounded to the nearest cent with halves away from zero
+// Exact while cents * millionths fits in 64 bits, which at a 5% rate is balances up to about $1.8 trillion
+money money::operator*(const fixedRate& _rate) const
+{
+	int64_t product = cents * _rate.getmillionths();
+	int64_t half = fixedRate::scale / 2;
+	return fromCents(product >= 0 ? (product + half) / fixedRate::scale : (product - half) / fixedRate::scale);
+}
+
+// toChars function writes the amount as dollars with two decimals, as -12.30 for -1230 cents
+char* money::toChars(char* _first, char* _last) const
+{
+	return writeFixed(_first, _last, cents, scale, 2, true);
+}
+#pragma endregion
+
+#pragma region Formatting Functions
+std::ostream& operator<<(std::ostream& _out, const money& _amount)
+{
+	char text[formattedChars];
+	return _out.write(text, _amount.toChars(text, text + sizeof(text)) - text);
+}
+
+std::ostream& operator<<(std::ostream& _out, const fixedRate& _rate)
+{
+	char text[formattedChars];
+	return _out.write(text, _rate.toChars(text, text + sizeof(text)) - text);
+}
+#pragma endregion
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// FixedRate class declaration
+//
+// An exact rate held as a whole number of millionths, so 0.05 is 50000.
+class fixedRate
+{
+public:
+	// Constructors
+	constexpr fixedRate() : millionths(0) {}
+	static constexpr fixedRate fromMillionths(int64_t _millionths)
+	{
+		fixedRate rate;
+		rate.millionths = _millionths;
+		return rate;
+	}
+
+	// Getters
+	constexpr int64_t getmillionths() const { return millionths; }
+
+	// Formatting
+	char* toChars(char* _first, char* _last) const;
+
+	bool operator==(const fixedRate& _other) const { return millionths == _other.millionths; }
+	bool operator!=(const fixedRate& _other) const { return millionths != _other.millionths; }
+
+	static const int64_t scale = 1000000;
+
+private:
+	// Attributes
+	int64_t millionths;
+};
+
+// Money class declaration
+//
+// An exact amount held as a whole number of cents, so sums and comparisons never round the way float balances did.
+// Only applying a rate rounds, to the nearest cent with halves away from zero.
+class money
+{
+public:
+	// Constructors
+	constexpr money() : cents(0) {}
+	static constexpr money fromCents(int64_t _cents)
+	{
+		money amount;
+		amount.cents = _cents;
+		return amount;
+	}
+
+	// Getters
+	constexpr int64_t getcents() const { return cents; }
+
+	// Arithmetic
+	money operator+(const money& _other) const { return fromCents(cents + _other.cents); }
+	money operator-(const money& _other) const { return fromCents(cents - _other.cents); }
+	money operator-() const { return fromCents(-cents); }
+	money& operator+=(const money& _other) { cents += _other.cents; return *this; }
+	money& operator-=(const money& _other) { cents -= _other.cents; return *this; }
+	money operator*(const fixedRate& _rate) const;
+
+	// Comparison
+	bool operator==(const money& _other) const { return cents == _other.cents; }
+	bool operator!=(const money& _other) const { return cents != _other.cents; }
+	bool operator<(const money& _other) const { return cents < _other.cents; }
+	bool operator<=(const money& _other) const { return cents <= _other.cents; }
+	bool operator>(const money& _other) const { return cents > _other.cents; }
+	bool operator>=(const money& _other) const { return cents >= _other.cents; }
+
+	// Formatting
+	char* toChars(char* _first, char* _last) const;
+
+	static const int64_t scale = 100;
+
+private:
+	// Attributes
+	int64_t cents;
+};
+
+// Formatting functions
+//
+// Write with std::to_chars only: money as dollars with two decimals, rates with up to six decimals and no trailing zeros.
+// toChars needs room for formattedChars characters and returns the end of what it wrote.
+const size_t formattedChars = 32;
+std::ostream& operator<<(std::ostream& _out, const money& _amount);
+std::ostream& operator<<(std::ostream& _out, const fixedRate& _rate);
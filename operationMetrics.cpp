@@ -0,0 +1,219 @@
+#include "operationMetrics.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#ifdef _WIN32
+#include <intrin.h>
+#endif
+
+namespace
+{
+	const char* const metricNames[METRIC_COUNT] =
+	{
+		"loadUser",
+		"loadLogin",
+		"loadLogin:credentials",
+		"loadLogin:profile",
+		"loadLogin:accounts",
+		"loadAccounts",
+		"userExistance",
+		"savingExistance",
+		"checkingExistance",
+		"createSaving",
+		"createChecking",
+		"updateSavingAccount",
+		"updateCheckingAccount",
+		"deposit",
+		"withdrawal",
+		"accrueInterest"
+	};
+
+	latencyHistogram histograms[METRIC_COUNT];
+
+	// highestBit function returns the index of the highest set bit of a non zero word
+	int highestBit(uint64_t _word)
+	{
+#ifdef _WIN32
+		unsigned long index;
+		_BitScanReverse64(&index, _word);
+		return static_cast<int>(index);
+#else
+		return 63 - __builtin_clzll(_word);
+#endif
+	}
+
+	// printMicroseconds function writes a duration in nanoseconds as microseconds, in a column of the report
+	void printMicroseconds(std::ostream& _out, double _nanoseconds)
+	{
+		_out << std::setw(12) << _nanoseconds / 1000;
+	}
+}
+
+#pragma region Latency Histogram Class Implementation
+// Constructors, used for latency histogram creation
+latencyHistogram::latencyHistogram()
+{
+	reset();
+}
+
+// Samples
+
+// record function adds one duration to the histogram
+void latencyHistogram::record(uint64_t _nanoseconds)
+{
+	counts[bucketOf(_nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+	totalNanoseconds.fetch_add(_nanoseconds, std::memory_order_relaxed);
+	uint64_t max = maxNanoseconds.load(std::memory_order_relaxed);
+	while (_nanoseconds > max && maxNanoseconds.compare_exchange_weak(max, _nanoseconds, std::memory_order_relaxed) == false)
+	{
+	}
+}
+
+void latencyHistogram::reset()
+{
+	for (std::atomic<uint64_t>& count : counts)
+	{
+		count.store(0, std::memory_order_relaxed);
+	}
+	totalNanoseconds.store(0, std::memory_order_relaxed);
+	maxNanoseconds.store(0, std::memory_order_relaxed);
+}
+
+// Getters, used for returning private attributes
+// The count is the sum of the buckets, so recording does not update a shared counter as well
+uint64_t latencyHistogram::getcount() const
+{
+	uint64_t count = 0;
+	for (const std::atomic<uint64_t>& bucket : counts)
+	{
+		count += bucket.load(std::memory_order_relaxed);
+	}
+	return count;
+}
+
+uint64_t latencyHistogram::gettotalNanoseconds() const
+{
+	return totalNanoseconds.load(std::memory_order_relaxed);
+}
+
+uint64_t latencyHistogram::getmaxNanoseconds() const
+{
+	return maxNanoseconds.load(std::memory_order_relaxed);
+}
+
+// getpercentile function returns the duration _fraction of the samples took at most, to within the bucket's width,
+// or 0 if nothing was recorded
+uint64_t latencyHistogram::getpercentile(double _fraction) const
+{
+	uint64_t count = getcount();
+	if (count == 0)
+	{
+		return 0;
+	}
+	uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(_fraction * count + 0.5));
+	uint64_t seen = 0;
+	for (size_t bucket = 0; bucket < bucketCount; bucket++)
+	{
+		seen += counts[bucket].load(std::memory_order_relaxed);
+		if (seen >= rank)
+		{
+			return std::min(bucketLimit(bucket), getmaxNanoseconds());
+		}
+	}
+	return getmaxNanoseconds();
+}
+
+// bucketOf function returns the bucket of a duration: its highest bits above the leading one pick the sub bucket
+size_t latencyHistogram::bucketOf(uint64_t _nanoseconds)
+{
+	if (_nanoseconds < subBuckets)
+	{
+		return static_cast<size_t>(_nanoseconds);
+	}
+	int shift = highestBit(_nanoseconds) - subBucketBits;
+	return static_cast<size_t>(shift + 1) * subBuckets + static_cast<size_t>((_nanoseconds >> shift) - subBuckets);
+}
+
+// bucketLimit function returns the largest duration that falls in the bucket
+uint64_t latencyHistogram::bucketLimit(size_t _bucket)
+{
+	if (_bucket < subBuckets)
+	{
+		return _bucket;
+	}
+	int shift = static_cast<int>(_bucket / subBuckets) - 1;
+	uint64_t lowest = (subBuckets + _bucket % subBuckets) << shift;
+	return lowest + ((uint64_t(1) << shift) - 1);
+}
+#pragma endregion
+
+#pragma region Operation Timer Class Implementation
+// Constructors, used for operation timer creation
+operationTimer::operationTimer(operationMetric _metric)
+{
+	metric = _metric;
+	start = std::chrono::steady_clock::now();
+}
+
+operationTimer::~operationTimer()
+{
+	std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+	histograms[metric].record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+}
+#pragma endregion
+
+#pragma region Metric Functions
+latencyHistogram& operationHistogram(operationMetric _metric)
+{
+	return histograms[_metric];
+}
+
+const char* operationName(operationMetric _metric)
+{
+	return metricNames[_metric];
+}
+
+void resetOperationMetrics()
+{
+	for (latencyHistogram& histogram : histograms)
+	{
+		histogram.reset();
+	}
+}
+
+void printOperationMetrics(std::ostream& _out)
+{
+	std::ios::fmtflags flags = _out.flags();
+	std::streamsize precision = _out.precision();
+	_out << std::fixed << std::setprecision(2);
+
+	_out << "Operation latency (microseconds)\n\n";
+	_out << std::left << std::setw(24) << "Operation" << std::right << std::setw(10) << "Count" << std::setw(12) << "Mean"
+		<< std::setw(12) << "p50" << std::setw(12) << "p90" << std::setw(12) << "p99" << std::setw(12) << "p99.9" << std::setw(12) << "Max" << "\n";
+	for (int metric = 0; metric < METRIC_COUNT; metric++)
+	{
+		const latencyHistogram& histogram = histograms[metric];
+		uint64_t count = histogram.getcount();
+		_out << std::left << std::setw(24) << metricNames[metric] << std::right << std::setw(10) << count;
+		printMicroseconds(_out, count > 0 ? static_cast<double>(histogram.gettotalNanoseconds()) / count : 0);
+		printMicroseconds(_out, static_cast<double>(histogram.getpercentile(0.50)));
+		printMicroseconds(_out, static_cast<double>(histogram.getpercentile(0.90)));
+		printMicroseconds(_out, static_cast<double>(histogram.getpercentile(0.99)));
+		printMicroseconds(_out, static_cast<double>(histogram.getpercentile(0.999)));
+		printMicroseconds(_out, static_cast<double>(histogram.getmaxNanoseconds()));
+		_out << "\n";
+	}
+
+	_out.flags(flags);
+	_out.precision(precision);
+}
+
+bool writeOperationMetrics(const std::string& _path)
+{
+	std::ofstream metricsFile(_path, std::ios::out | std::ios::trunc);
+	printOperationMetrics(metricsFile);
+	metricsFile.close();
+	return metricsFile.good();
+}
+#pragma endregion
@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// LatencyHistogram class declaration
+//
+// Counts durations in log-linear buckets, HDR histogram style: durations under subBuckets nanoseconds each get their
+// own bucket, and every doubling above that is split into subBuckets equal buckets, so any recorded duration is known
+// to within about 3% whatever its size. Recording is a bucket increment and a few relaxed atomic updates, without a
+// lock, so concurrent sessions can record into the same histogram.
+class latencyHistogram
+{
+public:
+	// Constructors
+	latencyHistogram();
+	latencyHistogram(const latencyHistogram&) = delete;
+	latencyHistogram& operator=(const latencyHistogram&) = delete;
+
+	// Samples
+	void record(uint64_t _nanoseconds);
+	void reset();
+
+	// Getters
+	uint64_t getcount() const;
+	uint64_t gettotalNanoseconds() const;
+	uint64_t getmaxNanoseconds() const;
+	uint64_t getpercentile(double _fraction) const;
+
+	static const int subBucketBits = 5;
+	static const uint64_t subBuckets = uint64_t(1) << subBucketBits;
+	static const size_t bucketCount = (64 - subBucketBits + 1) * subBuckets;
+
+private:
+	static size_t bucketOf(uint64_t _nanoseconds);
+	static uint64_t bucketLimit(size_t _bucket);
+
+	// Attributes
+	std::atomic<uint64_t> counts[bucketCount];
+	std::atomic<uint64_t> totalNanoseconds;
+	std::atomic<uint64_t> maxNanoseconds;
+};
+
+// operationMetric: the banking operations timed by operationTimer
+enum operationMetric
+{
+	METRIC_LOAD_USER,
+	METRIC_LOAD_LOGIN,
+	METRIC_LOGIN_CREDENTIALS,
+	METRIC_LOGIN_PROFILE,
+	METRIC_LOGIN_ACCOUNTS,
+	METRIC_LOAD_ACCOUNTS,
+	METRIC_USER_EXISTANCE,
+	METRIC_SAVING_EXISTANCE,
+	METRIC_CHECKING_EXISTANCE,
+	METRIC_CREATE_SAVING,
+	METRIC_CREATE_CHECKING,
+	METRIC_UPDATE_SAVING,
+	METRIC_UPDATE_CHECKING,
+	METRIC_DEPOSIT,
+	METRIC_WITHDRAWAL,
+	METRIC_ACCRUE_INTEREST,
+	METRIC_COUNT
+};
+
+// OperationTimer class declaration
+//
+// Times the scope it is declared in and records the duration in the histogram of its operation when it goes out of scope.
+class operationTimer
+{
+public:
+	// Constructors
+	explicit operationTimer(operationMetric _metric);
+	~operationTimer();
+	operationTimer(const operationTimer&) = delete;
+	operationTimer& operator=(const operationTimer&) = delete;
+
+private:
+	// Attributes
+	operationMetric metric;
+	std::chrono::steady_clock::time_point start;
+};
+
+// Metric functions
+//
+// Every operation has one histogram for the whole program. printOperationMetrics prints the count, mean and
+// percentiles of each operation as a table in microseconds, and writeOperationMetrics writes the same table to a file.
+latencyHistogram& operationHistogram(operationMetric _metric);
+const char* operationName(operationMetric _metric);
+void resetOperationMetrics();
+void printOperationMetrics(std::ostream& _out);
+bool writeOperationMetrics(const std::string& _path);
@@ -0,0 +1,146 @@
+#include "persistenceQueue.h"
+#include <thread>
+#include <utility>
+
+std::atomic<persistenceQueue::node*> persistenceQueue::freeNodes(nullptr);
+
+#pragma region Persistence Queue Class Implementation
+// Constructors, used for persistence queue creation
+// The queue always holds one node whose request has already been taken, so head and tail are never null
+persistenceQueue::persistenceQueue()
+{
+	node* stub = acquireNode();
+	stub->next.store(nullptr, std::memory_order_relaxed);
+	head.store(stub, std::memory_order_relaxed);
+	tail = stub;
+	pushed.store(0, std::memory_order_relaxed);
+	drained.store(0, std::memory_order_relaxed);
+}
+
+persistenceQueue::~persistenceQueue()
+{
+	while (tail != nullptr)
+	{
+		node* next = tail->next.load(std::memory_order_relaxed);
+		delete tail;
+		tail = next;
+	}
+}
+
+// Requests
+
+// push function adds a request from any thread without taking a lock
+// The request is swapped into a pooled node, so _request is left empty but with the spare buffers of an earlier request
+void persistenceQueue::push(persistRequest& _request)
+{
+	node* added = acquireNode();
+	added->next.store(nullptr, std::memory_order_relaxed);
+	std::swap(added->request, _request);
+	node* previous = head.exchange(added, std::memory_order_acq_rel);
+	previous->next.store(added, std::memory_order_release);
+	pushed.fetch_add(1, std::memory_order_release);
+}
+
+// drain function moves every request pushed before the call into the first elements of _requests, oldest first,
+// and returns how many it took
+// _requests only grows, so the requests it keeps from earlier drains lend their buffers to later pushes
+// Only the persistence thread calls it
+size_t persistenceQueue::drain(std::vector<persistRequest>& _requests)
+{
+	// Every push that finished before this point has swapped its node in at or before last
+	node* last = head.load(std::memory_order_acquire);
+	size_t count = 0;
+	while (tail != last)
+	{
+		if (count == _requests.size())
+		{
+			_requests.emplace_back();
+		}
+		if (pop(_requests[count]) == false)
+		{
+			// A push has swapped the head but not linked its node yet
+			std::this_thread::yield();
+			continue;
+		}
+		count++;
+	}
+	drained.fetch_add(count, std::memory_order_relaxed);
+	return count;
+}
+
+// pop function takes the oldest linked request into _request, or returns false if no node is linked after the tail
+// The request _request held before is cleared and left in that node, and the old tail goes back to the pool
+bool persistenceQueue::pop(persistRequest& _request)
+{
+	node* next = tail->next.load(std::memory_order_acquire);
+	if (next == nullptr)
+	{
+		return false;
+	}
+	_request.clear();
+	std::swap(_request, next->request);
+	node* taken = tail;
+	tail = next;
+	releaseNodes(taken, taken);
+	return true;
+}
+
+// acquireNode function returns an unused node, from the calling thread's cache, else from the pool, else a new one
+// The cache hands its nodes back to the pool when the thread exits
+persistenceQueue::node* persistenceQueue::acquireNode()
+{
+	struct nodeCache
+	{
+		node* first = nullptr;
+
+		~nodeCache()
+		{
+			if (first != nullptr)
+			{
+				node* last = first;
+				while (last->next.load(std::memory_order_relaxed) != nullptr)
+				{
+					last = last->next.load(std::memory_order_relaxed);
+				}
+				releaseNodes(first, last);
+			}
+		}
+	};
+	thread_local nodeCache cache;
+
+	if (cache.first == nullptr)
+	{
+		cache.first = freeNodes.exchange(nullptr, std::memory_order_acquire);
+		if (cache.first == nullptr)
+		{
+			return new node;
+		}
+	}
+	node* taken = cache.first;
+	cache.first = taken->next.load(std::memory_order_relaxed);
+	return taken;
+}
+
+// releaseNodes function adds a list of unused nodes, linked from _first to _last, to the pool
+// A list is only linked in front of whatever head the exchange finds, and threads take the whole pool at once, so
+// unlike a lock-free stack that pops single nodes the pool has no ABA problem
+void persistenceQueue::releaseNodes(node* _first, node* _last)
+{
+	node* pooled = freeNodes.load(std::memory_order_relaxed);
+	do
+	{
+		_last->next.store(pooled, std::memory_order_relaxed);
+	} while (freeNodes.compare_exchange_weak(pooled, _first, std::memory_order_release, std::memory_order_relaxed) == false);
+}
+
+// Getters, used for returning private attributes
+uint64_t persistenceQueue::getpushCount() const
+{
+	return pushed.load(std::memory_order_acquire);
+}
+
+uint64_t persistenceQueue::getpendingCount() const
+{
+	return pushed.load(std::memory_order_acquire) - drained.load(std::memory_order_relaxed);
+}
+#pragma endregion
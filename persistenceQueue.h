@@ -0,0 +1,73 @@
+#pragma once
+#include "accountLedger.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// persistRequest: the file writes of one change, made later by the persistence thread
+// userLine is appended to userData.txt and accountLine to userAccountLog.txt unless empty; events go to the ledger
+struct persistRequest
+{
+	std::string userLine;
+	std::string accountLine;
+	std::vector<ledgerEvent> events;
+
+	// clear function empties the request but keeps its buffers for the next one
+	void clear()
+	{
+		userLine.clear();
+		accountLine.clear();
+		events.clear();
+	}
+};
+
+// PersistenceQueue class declaration
+//
+// A lock-free queue of persistRequests from any number of threads to the single persistence thread. push() links a
+// new node with one atomic exchange, so submitting never waits on a lock or on another submitter. drain() may only be
+// called from one thread at a time; it takes every request pushed before it was called, in the order they were pushed.
+//
+// A push exchanges its node into the head and then links the node it replaced to it, so for a moment a later push
+// can be complete while an earlier one is not yet reachable. drain() therefore reads the head when it starts and keeps
+// taking nodes until it has taken that one, yielding through such a moment; pushes that finished before the call
+// swapped their nodes in no later than that head, so none is missed.
+//
+// Requests are swapped rather than copied in and out, and drained nodes go back to a pool shared by every queue, so
+// once the buffers have grown to the usual request size neither side allocates.
+class persistenceQueue
+{
+public:
+	// Constructors
+	persistenceQueue();
+	~persistenceQueue();
+	persistenceQueue(const persistenceQueue&) = delete;
+	persistenceQueue& operator=(const persistenceQueue&) = delete;
+
+	// Requests
+	void push(persistRequest& _request);
+	size_t drain(std::vector<persistRequest>& _requests);
+
+	// Getters
+	uint64_t getpushCount() const;
+	uint64_t getpendingCount() const;
+
+private:
+	struct node
+	{
+		std::atomic<node*> next;
+		persistRequest request;
+	};
+
+	bool pop(persistRequest& _request);
+	static node* acquireNode();
+	static void releaseNodes(node* _first, node* _last);
+
+	// Attributes
+	// Drained nodes, pushed back one list at a time by the persistence threads and taken whole by the threads that push
+	static std::atomic<node*> freeNodes;
+	std::atomic<node*> head;
+	node* tail;
+	std::atomic<uint64_t> pushed;
+	std::atomic<uint64_t> drained;
+};
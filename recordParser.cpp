@@ -0,0 +1,328 @@
+#include "recordParser.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+	const size_t blockSize = 1 << 16;
+
+	bool isDigit(char _character)
+	{
+		return _character >= '0' && _character <= '9';
+	}
+
+	// parseFixed function converts a whole decimal field to a count of 1 / _scale units, where _scale is 10 ^ _decimals,
+	// using integer arithmetic only. Digits past _decimals round to the nearest unit with halves away from zero.
+	// Fields in exponent form, which the float versions of the program could write, are converted through a double instead
+	bool parseFixed(std::string_view _field, int64_t _scale, int _decimals, int64_t& _units)
+	{
+		if (_field.find_first_of("eE") != std::string_view::npos)
+		{
+			double value = 0;
+			std::from_chars_result result = std::from_chars(_field.data(), _field.data() + _field.size(), value);
+			if (result.ec != std::errc() || result.ptr != _field.data() + _field.size() || std::fabs(value) > 9.0e16 / _scale)
+			{
+				return false;
+			}
+			_units = std::llround(value * _scale);
+			return true;
+		}
+
+		size_t position = 0;
+		bool negative = false;
+		if (position < _field.size() && (_field[position] == '-' || _field[position] == '+'))
+		{
+			negative = _field[position] == '-';
+			position++;
+		}
+
+		// Keeps whole * _scale plus the fraction inside 64 bits
+		const int64_t maxWhole = (std::numeric_limits<int64_t>::max() - _scale) / _scale;
+		int64_t whole = 0;
+		size_t wholeDigits = 0;
+		while (position < _field.size() && isDigit(_field[position]))
+		{
+			whole = whole * 10 + (_field[position] - '0');
+			if (whole > maxWhole)
+			{
+				return false;
+			}
+			wholeDigits++;
+			position++;
+		}
+
+		int64_t fraction = 0;
+		int fractionDigits = 0;
+		bool roundAway = false;
+		if (position < _field.size() && _field[position] == '.')
+		{
+			position++;
+			while (position < _field.size() && isDigit(_field[position]))
+			{
+				if (fractionDigits < _decimals)
+				{
+					fraction = fraction * 10 + (_field[position] - '0');
+				}
+				else if (fractionDigits == _decimals)
+				{
+					roundAway = _field[position] >= '5';
+				}
+				fractionDigits++;
+				position++;
+			}
+		}
+		if (position != _field.size() || wholeDigits + static_cast<size_t>(fractionDigits) == 0)
+		{
+			return false;
+		}
+
+		for (int digit = fractionDigits; digit < _decimals; digit++)
+		{
+			fraction *= 10;
+		}
+		int64_t units = whole * _scale + fraction + (roundAway ? 1 : 0);
+		_units = negative ? -units : units;
+		return true;
+	}
+}
+
+#pragma region Record Parsing Functions
+// splitRecord function writes up to _maxFields ':' separated fields of _line into _fields and returns how many were found
+// A trailing ':' does not start another field, matching how every record is written
+size_t splitRecord(std::string_view _line, std::string_view* _fields, size_t _maxFields)
+{
+	size_t count = 0;
+	size_t position = 0;
+	while (count < _maxFields && position < _line.size())
+	{
+		size_t separator = _line.find(':', position);
+		if (separator == std::string_view::npos)
+		{
+			separator = _line.size();
+		}
+		_fields[count] = _line.substr(position, separator - position);
+		count++;
+		position = separator + 1;
+	}
+	return count;
+}
+
+// parseInt function converts a whole field to an int, returning false if it is not a number
+bool parseInt(std::string_view _field, int& _value)
+{
+	std::from_chars_result result = std::from_chars(_field.data(), _field.data() + _field.size(), _value);
+	return result.ec == std::errc() && result.ptr == _field.data() + _field.size();
+}
+
+// parseMoney function converts a whole field such as 12.34 to cents, returning false if it is not a number
+bool parseMoney(std::string_view _field, money& _value)
+{
+	int64_t cents = 0;
+	if (parseFixed(_field, money::scale, 2, cents) == false)
+	{
+		return false;
+	}
+	_value = money::fromCents(cents);
+	return true;
+}
+
+// parseRate function converts a whole field such as 0.05 to millionths, returning false if it is not a number
+bool parseRate(std::string_view _field, fixedRate& _value)
+{
+	int64_t millionths = 0;
+	if (parseFixed(_field, fixedRate::scale, 6, millionths) == false)
+	{
+		return false;
+	}
+	_value = fixedRate::fromMillionths(millionths);
+	return true;
+}
+
+// parseAccountLine function splits a userAccountData.txt line and converts its numeric fields
+// Returns false if the line does not have every field or a numeric field is not a number
+bool parseAccountLine(std::string_view _line, accountLine& _account)
+{
+	std::string_view fields[8];
+	size_t fieldCount = splitRecord(_line, fields, 8);
+	if (fieldCount < 7)
+	{
+		return false;
+	}
+
+	_account.type = fields[0];
+	_account.username = fields[1];
+	_account.interestRate = fixedRate();
+	_account.overdraftLimit = money();
+	_account.accrualDay = 0;
+	bool rateParsed = _account.type == "Saving" ? parseRate(fields[3], _account.interestRate) : parseMoney(fields[3], _account.overdraftLimit);
+	bool accrualParsed = fieldCount < 8 || fields[7].empty() || parseInt(fields[7], _account.accrualDay);
+	return parseMoney(fields[2], _account.balance) && rateParsed && parseInt(fields[4], _account.id)
+		&& parseInt(fields[5], _account.depositCount) && parseInt(fields[6], _account.withdrawalCount) && accrualParsed;
+}
+#pragma endregion
+
+#pragma region Log Generation Functions
+// parseGenerationLine function reads the number of a "Generation:n:" line, returning false for any other line
+bool parseGenerationLine(std::string_view _line, uint64_t& _generation)
+{
+	std::string_view fields[3];
+	if (splitRecord(_line, fields, 3) != 2 || fields[0] != "Generation")
+	{
+		return false;
+	}
+	std::from_chars_result result = std::from_chars(fields[1].data(), fields[1].data() + fields[1].size(), _generation);
+	return result.ec == std::errc() && result.ptr == fields[1].data() + fields[1].size();
+}
+
+// appendGenerationLine function appends the "Generation:n:" line for _generation to _line
+void appendGenerationLine(std::string& _line, uint64_t _generation)
+{
+	char digits[24];
+	_line += "Generation:";
+	_line.append(digits, std::to_chars(digits, digits + sizeof(digits), _generation).ptr);
+	_line += ":\n";
+}
+
+// readSnapshotGeneration function returns the generation on the first line of a snapshot, or 0 if it has none
+uint64_t readSnapshotGeneration(const std::string& _path)
+{
+	recordReader snapshot;
+	std::string_view line;
+	uint64_t generation = 0;
+	if (snapshot.open(_path) && snapshot.nextLine(line) && parseGenerationLine(line, generation))
+	{
+		return generation;
+	}
+	return 0;
+}
+
+// readSealedGeneration function returns the highest generation in a sealed segment, which a failed snapshot can leave
+// to be sealed onto again, or 0 if it has none or does not exist
+uint64_t readSealedGeneration(const std::string& _path)
+{
+	recordReader sealed;
+	sealed.open(_path);
+	std::string_view line;
+	uint64_t highest = 0;
+	while (sealed.nextLine(line))
+	{
+		uint64_t generation = 0;
+		if (parseGenerationLine(line, generation))
+		{
+			highest = std::max(highest, generation);
+		}
+	}
+	return highest;
+}
+#pragma endregion
+
+#pragma region Record Reader Class Implementation
+// Constructors, used for record reader creation
+recordReader::recordReader()
+{
+	start = 0;
+	end = 0;
+	endOfFile = true;
+}
+
+// Opening and closing
+
+// open function opens the file at _path for reading, returning false if it does not exist
+bool recordReader::open(const std::string& _path)
+{
+	close();
+	file.open(_path, std::ios::in | std::ios::binary);
+	if (file.is_open() == false)
+	{
+		return false;
+	}
+	buffer.resize(blockSize);
+	endOfFile = false;
+	return true;
+}
+
+void recordReader::close()
+{
+	if (file.is_open())
+	{
+		file.close();
+	}
+	file.clear();
+	start = 0;
+	end = 0;
+	endOfFile = true;
+}
+
+// Reading
+
+// nextLine function points _line at the next line without its line ending, returning false at the end of the file
+bool recordReader::nextLine(std::string_view& _line)
+{
+	while (true)
+	{
+		const char* first = buffer.data() + start;
+		const char* newline = nullptr;
+		if (end > start)
+		{
+			newline = static_cast<const char*>(std::memchr(first, '\n', end - start));
+		}
+		if (newline != nullptr)
+		{
+			size_t length = newline - first;
+			start += length + 1;
+			if (length > 0 && first[length - 1] == '\r')
+			{
+				length--;
+			}
+			_line = std::string_view(first, length);
+			return true;
+		}
+
+		if (endOfFile)
+		{
+			if (start == end)
+			{
+				return false;
+			}
+			size_t length = end - start;
+			start = end;
+			if (first[length - 1] == '\r')
+			{
+				length--;
+			}
+			_line = std::string_view(first, length);
+			return true;
+		}
+
+		fill();
+	}
+}
+
+// fill function moves the unread part of the buffer to the front and reads the next block after it
+// The buffer doubles when a single line does not fit
+bool recordReader::fill()
+{
+	if (start > 0)
+	{
+		std::memmove(buffer.data(), buffer.data() + start, end - start);
+		end -= start;
+		start = 0;
+	}
+	if (end == buffer.size())
+	{
+		buffer.resize(buffer.size() * 2);
+	}
+
+	file.read(buffer.data() + end, static_cast<std::streamsize>(buffer.size() - end));
+	std::streamsize bytesRead = file.gcount();
+	end += static_cast<size_t>(bytesRead);
+	if (bytesRead == 0 || file.eof())
+	{
+		endOfFile = true;
+	}
+	return bytesRead > 0;
+}
+#pragma endregion
@@ -0,0 +1,77 @@
+#pragma once
+#include "money.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Record parsing functions
+//
+// Records in userData.txt and userAccountData.txt are lines of ':' separated fields.
+// splitRecord cuts a line into string_views over the caller's buffer without copying any field,
+// and the parse functions convert numeric fields with std::from_chars instead of a stringstream per field.
+// Amounts and rates are read as whole cents and millionths with integer arithmetic only.
+size_t splitRecord(std::string_view _line, std::string_view* _fields, size_t _maxFields);
+bool parseInt(std::string_view _field, int& _value);
+bool parseMoney(std::string_view _field, money& _value);
+bool parseRate(std::string_view _field, fixedRate& _value);
+
+// accountLine: the fields of one userAccountData.txt line
+// The fourth field is read into interestRate for a Saving line and into overdraftLimit otherwise
+// A Saving line may end with the day interest was last accrued; accrualDay is 0 for lines written before it was kept
+// type and username point into the line that was parsed
+struct accountLine
+{
+	std::string_view type;
+	std::string_view username;
+	money balance;
+	fixedRate interestRate;
+	money overdraftLimit;
+	int id;
+	int depositCount;
+	int withdrawalCount;
+	int accrualDay;
+};
+
+bool parseAccountLine(std::string_view _line, accountLine& _account);
+
+// Log generation functions
+//
+// Sealing the account log ends the sealed segment with a "Generation:n:" line, numbering the seals in order, and a
+// snapshot starts with the same line for the last seal it holds. A sealed segment whose generation the snapshot has
+// reached is already in it and must not be replayed, since it can be older than changes only the snapshot holds.
+// Both are 0 for files written before generations were kept; account parsing skips the lines.
+bool parseGenerationLine(std::string_view _line, uint64_t& _generation);
+void appendGenerationLine(std::string& _line, uint64_t _generation);
+uint64_t readSnapshotGeneration(const std::string& _path);
+uint64_t readSealedGeneration(const std::string& _path);
+
+// RecordReader class declaration
+//
+// Reads a text file in large blocks and hands out each line as a string_view into its buffer.
+// A line is only valid until the next call to nextLine.
+class recordReader
+{
+public:
+	// Constructors
+	recordReader();
+
+	// Opening and closing
+	bool open(const std::string& _path);
+	void close();
+
+	// Reading
+	bool nextLine(std::string_view& _line);
+
+private:
+	bool fill();
+
+	// Attributes
+	std::ifstream file;
+	std::vector<char> buffer;
+	size_t start;
+	size_t end;
+	bool endOfFile;
+};
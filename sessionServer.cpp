@@ -0,0 +1,515 @@
+#include "sessionServer.h"
+#include "bankFunctions.h"
+#include "recordParser.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef _WIN32
+	typedef SOCKET socketHandle;
+	const socketHandle invalidSocket = INVALID_SOCKET;
+	const int sendFlags = 0;
+#else
+	typedef int socketHandle;
+	const socketHandle invalidSocket = -1;
+#ifdef MSG_NOSIGNAL
+	const int sendFlags = MSG_NOSIGNAL;
+#else
+	const int sendFlags = 0;
+#endif
+#endif
+
+	void closeSocket(socketHandle _socket)
+	{
+#ifdef _WIN32
+		closesocket(_socket);
+#else
+		::close(_socket);
+#endif
+	}
+
+	// The listening socket and every connected client, so a shutdown can wake the accept loop and end idle sessions
+	socketHandle listener = invalidSocket;
+	std::atomic<bool> stopping(false);
+	std::mutex clientsMutex;
+	std::condition_variable clientsDone;
+	std::unordered_set<socketHandle> clients;
+
+	// stopServer function makes the accept loop return; it only shuts the listening socket down, so a signal handler
+	// can call it
+	void stopServer()
+	{
+		stopping = true;
+#ifdef _WIN32
+		shutdown(listener, SD_BOTH);
+		closesocket(listener);
+#else
+		shutdown(listener, SHUT_RDWR);
+#endif
+	}
+
+	void onStopSignal(int)
+	{
+		stopServer();
+	}
+
+	// acceptFailure: what the accept loop does after accept fails
+	enum acceptFailure { ACCEPT_RETRY, ACCEPT_BACK_OFF, ACCEPT_FATAL };
+
+	// The longest the accept loop waits for descriptors to be freed before it tries again
+	const std::chrono::milliseconds maxAcceptBackOff(1000);
+
+	// classifyAcceptFailure function sorts the error of the accept that just failed: an interrupted call or a client that
+	// dropped before it was accepted is retried at once, running out of descriptors or buffers is waited out, and
+	// anything else ends the server
+	acceptFailure classifyAcceptFailure()
+	{
+#ifdef _WIN32
+		int error = WSAGetLastError();
+		if (error == WSAEINTR || error == WSAECONNRESET)
+		{
+			return ACCEPT_RETRY;
+		}
+		if (error == WSAEMFILE || error == WSAENOBUFS)
+		{
+			return ACCEPT_BACK_OFF;
+		}
+#else
+		int error = errno;
+		if (error == EINTR || error == ECONNABORTED)
+		{
+			return ACCEPT_RETRY;
+		}
+		if (error == EMFILE || error == ENFILE || error == ENOBUFS || error == ENOMEM)
+		{
+			return ACCEPT_BACK_OFF;
+		}
+#endif
+		return ACCEPT_FATAL;
+	}
+
+	// sendLine function writes one reply line to the client, returning false once the client has gone
+	bool sendLine(socketHandle _socket, const std::string& _line)
+	{
+		std::string reply = _line + "\n";
+		size_t sent = 0;
+		while (sent < reply.size())
+		{
+			int written = send(_socket, reply.data() + sent, static_cast<int>(reply.size() - sent), sendFlags);
+			if (written <= 0)
+			{
+				return false;
+			}
+			sent += static_cast<size_t>(written);
+		}
+		return true;
+	}
+
+	// receiveLine function returns the next request line in _line, reading more from the client into _buffer as needed
+	// A trailing '\r' is dropped so telnet style clients work. Returns false once the client has gone
+	bool receiveLine(socketHandle _socket, std::string& _buffer, std::string& _line)
+	{
+		size_t newline = _buffer.find('\n');
+		while (newline == std::string::npos)
+		{
+			char block[4096];
+			int received = recv(_socket, block, sizeof(block), 0);
+			if (received <= 0)
+			{
+				return false;
+			}
+			_buffer.append(block, static_cast<size_t>(received));
+			newline = _buffer.find('\n');
+		}
+
+		_line = _buffer.substr(0, newline);
+		_buffer.erase(0, newline + 1);
+		if (_line.empty() == false && _line.back() == '\r')
+		{
+			_line.pop_back();
+		}
+		return true;
+	}
+
+	std::string balanceReply(const char* _result, money _balance)
+	{
+		std::stringstream reply;
+		reply << "OK:" << _result << ":" << _balance << ":";
+		return reply.str();
+	}
+
+	// session: the logged in state of one client, the counterpart of main's user, userChecking and userSaving
+	struct session
+	{
+		accountStore& store;
+		customerHandle user;
+		bool loggedIn;
+		// Ids for the accounts this session creates, leased in blocks so sessions do not contend on the allocator
+		idLease accountIds;
+
+		session(accountStore& _store) : store(_store), accountIds(_store.getidAllocator())
+		{
+			loggedIn = false;
+		}
+
+		// login function checks the credentials with loadUser; interest accrues when the balance is read, so nothing is written
+		std::string login(std::string_view _username, std::string_view _password)
+		{
+			customerHandle loginUser;
+			if (loadUser(loginUser, store, std::string(_password), std::string(_username)) == false)
+			{
+				return "ERROR:LoginFailed:";
+			}
+			user = loginUser;
+			loggedIn = true;
+			return "OK:" + user->getfirstName() + ":";
+		}
+
+		std::string create(std::string_view _type)
+		{
+			std::stringstream reply;
+			if (_type == "Saving")
+			{
+				std::unique_lock<std::mutex> accountLock = store.lockSaving(user->getusername());
+				savingAccount userSaving;
+				if (savingExistance(store, *user))
+				{
+					return "ERROR:AccountExists:";
+				}
+				if (createSaving(store, user, accountIds.next(), userSaving) == false)
+				{
+					return "ERROR:FileHandling:";
+				}
+				reply << "OK:" << userSaving.getid() << ":";
+			}
+			else if (_type == "Checking")
+			{
+				std::unique_lock<std::mutex> accountLock = store.lockChecking(user->getusername());
+				checkingAccount userChecking;
+				if (checkingExistance(store, *user))
+				{
+					return "ERROR:AccountExists:";
+				}
+				if (createChecking(store, user, accountIds.next(), userChecking) == false)
+				{
+					return "ERROR:FileHandling:";
+				}
+				reply << "OK:" << userChecking.getid() << ":";
+			}
+			else
+			{
+				return "ERROR:UnknownAccountType:";
+			}
+			return reply.str();
+		}
+
+		std::string display(std::string_view _type)
+		{
+			std::stringstream reply;
+			if (_type == "Saving")
+			{
+				savingAccount userSaving;
+				if (store.findSaving(user->getusername(), userSaving) == false)
+				{
+					return "ERROR:NoAccount:";
+				}
+				reply << "OK:" << userSaving.getbalance() << ":" << userSaving.getinterestRate() << ":" << userSaving.getid()
+					<< ":" << userSaving.getdepositCount() << ":" << userSaving.getwithdrawalCount() << ":";
+			}
+			else if (_type == "Checking")
+			{
+				checkingAccount userChecking;
+				if (store.findChecking(user->getusername(), userChecking) == false)
+				{
+					return "ERROR:NoAccount:";
+				}
+				reply << "OK:" << userChecking.getbalance() << ":" << userChecking.getoverdraftLimit() << ":" << userChecking.getid()
+					<< ":" << userChecking.getdepositCount() << ":" << userChecking.getwithdrawalCount() << ":";
+			}
+			else
+			{
+				return "ERROR:UnknownAccountType:";
+			}
+			return reply.str();
+		}
+
+		// change function applies a deposit or withdrawal with the same rules as depositAccount and withdrawAccount,
+		// holding the account's lock from the read to the write back
+		std::string change(std::string_view _type, std::string_view _amount, bool _deposit)
+		{
+			money amount;
+			if (parseMoney(_amount, amount) == false)
+			{
+				return "ERROR:Malformed:";
+			}
+
+			if (_type == "Saving")
+			{
+				std::unique_lock<std::mutex> accountLock = store.lockSaving(user->getusername());
+				savingAccount userSaving;
+				if (store.findSaving(user->getusername(), userSaving) == false)
+				{
+					return "ERROR:NoAccount:";
+				}
+				return applyChange(userSaving, amount, _deposit);
+			}
+			if (_type == "Checking")
+			{
+				std::unique_lock<std::mutex> accountLock = store.lockChecking(user->getusername());
+				checkingAccount userChecking;
+				if (store.findChecking(user->getusername(), userChecking) == false)
+				{
+					return "ERROR:NoAccount:";
+				}
+				return applyChange(userChecking, amount, _deposit);
+			}
+			return "ERROR:UnknownAccountType:";
+		}
+
+		template <typename accountClass>
+		std::string applyChange(accountClass& _account, money _amount, bool _deposit)
+		{
+			const char* result = "Deposited";
+			if (_deposit)
+			{
+				if (_amount <= money())
+				{
+					return "ERROR:InvalidAmount:";
+				}
+				_account.deposit(_amount);
+			}
+			else
+			{
+				withdrawalResult withdrawal = _account.applyWithdrawal(_amount);
+				if (withdrawal == INVALID_AMOUNT)
+				{
+					return "ERROR:InvalidAmount:";
+				}
+				if (withdrawal == INSUFFICIENT_BALANCE)
+				{
+					return "ERROR:InsufficientBalance:";
+				}
+				result = withdrawal == WITHDRAWN_WITH_FEE ? "WithdrawnWithFee" : "Withdrawn";
+			}
+
+			if (persist(_account) == false)
+			{
+				return "ERROR:FileHandling:";
+			}
+			return balanceReply(result, _account.getbalance());
+		}
+
+		bool persist(savingAccount& _userSaving)
+		{
+			return store.updateSaving(_userSaving);
+		}
+
+		bool persist(checkingAccount& _userChecking)
+		{
+			return store.updateChecking(_userChecking);
+		}
+
+		// handle function answers one request line and sets _quit when the client asked to disconnect
+		std::string handle(std::string_view _request, bool& _quit)
+		{
+			// command and up to two arguments
+			std::string_view fields[3];
+			size_t count = splitRecord(_request, fields, 3);
+			std::string_view command = fields[0];
+
+			if (command == "QUIT")
+			{
+				_quit = true;
+				return "OK:";
+			}
+			if (command == "LOGIN")
+			{
+				return count == 3 ? login(fields[1], fields[2]) : "ERROR:Malformed:";
+			}
+			if (command != "CREATE" && command != "DISPLAY" && command != "DEPOSIT" && command != "WITHDRAW" && command != "LOGOUT")
+			{
+				return "ERROR:UnknownCommand:";
+			}
+			if (loggedIn == false)
+			{
+				return "ERROR:NotLoggedIn:";
+			}
+
+			if (command == "LOGOUT")
+			{
+				user.reset();
+				loggedIn = false;
+				return "OK:";
+			}
+			if (command == "CREATE" || command == "DISPLAY")
+			{
+				if (count < 2)
+				{
+					return "ERROR:Malformed:";
+				}
+				return command == "CREATE" ? create(fields[1]) : display(fields[1]);
+			}
+			if (count < 3)
+			{
+				return "ERROR:Malformed:";
+			}
+			return change(fields[1], fields[2], command == "DEPOSIT");
+		}
+	};
+
+	// serveClient function runs one client's session until it quits or disconnects, or the server shuts down
+	void serveClient(accountStore& _store, socketHandle _client)
+	{
+		{
+			session clientSession(_store);
+			std::string buffer, request;
+			bool quit = false;
+			while (quit == false && receiveLine(_client, buffer, request))
+			{
+				if (sendLine(_client, clientSession.handle(request, quit)) == false)
+				{
+					break;
+				}
+			}
+		}
+
+		std::lock_guard<std::mutex> clientsLock(clientsMutex);
+		clients.erase(_client);
+		closeSocket(_client);
+		clientsDone.notify_all();
+	}
+
+	// endSessions function stops every session from reading further requests and waits for them to finish the
+	// request they are answering
+	void endSessions()
+	{
+		std::unique_lock<std::mutex> clientsLock(clientsMutex);
+		for (socketHandle client : clients)
+		{
+#ifdef _WIN32
+			shutdown(client, SD_RECEIVE);
+#else
+			shutdown(client, SHUT_RD);
+#endif
+		}
+		clientsDone.wait(clientsLock, []() { return clients.empty(); });
+	}
+}
+
+#pragma region Session Server Functions
+// runServer function accepts clients on 127.0.0.1:_port and serves each on its own thread until the process gets
+// SIGINT or SIGTERM, then lets every session finish its request and returns
+// Returns false if the port could not be opened or accept failed with an error that waiting does not clear
+bool runServer(accountStore& _store, unsigned short _port)
+{
+#ifdef _WIN32
+	WSADATA winsockData;
+	if (WSAStartup(MAKEWORD(2, 2), &winsockData) != 0)
+	{
+		std::cout << "ERROR: Could not start Winsock\n";
+		return false;
+	}
+#endif
+
+	listener = socket(AF_INET, SOCK_STREAM, 0);
+	if (listener == invalidSocket)
+	{
+		std::cout << "ERROR: Could not create a socket\n";
+		return false;
+	}
+
+	int reuse = 1;
+	setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(_port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0)
+	{
+		std::cout << "ERROR: Could not listen on port " << _port << "\n";
+		closeSocket(listener);
+		return false;
+	}
+
+	stopping = false;
+	void (*previousInterrupt)(int) = std::signal(SIGINT, onStopSignal);
+	void (*previousTerminate)(int) = std::signal(SIGTERM, onStopSignal);
+	std::cout << "Listening on 127.0.0.1:" << _port << "\n";
+	bool failed = false;
+	std::chrono::milliseconds backOff(0);
+	while (stopping == false)
+	{
+		socketHandle client = accept(listener, nullptr, nullptr);
+		if (client == invalidSocket)
+		{
+			if (stopping)
+			{
+				break;
+			}
+			acceptFailure failure = classifyAcceptFailure();
+			if (failure == ACCEPT_RETRY)
+			{
+				continue;
+			}
+			if (failure == ACCEPT_BACK_OFF)
+			{
+				// Sessions free descriptors as they end, so wait for them with a growing pause instead of spinning on the error
+				backOff = std::min(maxAcceptBackOff, std::max(std::chrono::milliseconds(10), backOff * 2));
+				std::this_thread::sleep_for(backOff);
+				continue;
+			}
+			std::cout << "ERROR: Could not accept a client\n";
+			failed = true;
+			break;
+		}
+		backOff = std::chrono::milliseconds(0);
+		if (stopping)
+		{
+			closeSocket(client);
+			break;
+		}
+		std::lock_guard<std::mutex> clientsLock(clientsMutex);
+		clients.insert(client);
+		std::thread(serveClient, std::ref(_store), client).detach();
+	}
+	std::signal(SIGINT, previousInterrupt);
+	std::signal(SIGTERM, previousTerminate);
+
+	endSessions();
+#ifndef _WIN32
+	closeSocket(listener);
+#endif
+	listener = invalidSocket;
+	std::cout << "Server stopped\n";
+#ifdef _WIN32
+	WSACleanup();
+#endif
+	return failed == false;
+}
+#pragma endregion
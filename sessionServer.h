@@ -0,0 +1,20 @@
+#pragma once
+#include "accountStore.h"
+
+// Session server functions
+//
+// Listens on a local TCP port and runs one session per connected client on its own thread, all sharing one store.
+// A session is the menu flow without the menus: each request is one line of ':' separated fields and gets one reply line.
+//
+//	LOGIN:username:password:			OK:first name:
+//	CREATE:Saving|Checking:				OK:id:
+//	DISPLAY:Saving|Checking:			OK:balance:rate:id:deposit count:withdrawal count:
+//	DEPOSIT:Saving|Checking:amount:		OK:Deposited:balance:
+//	WITHDRAW:Saving|Checking:amount:	OK:Withdrawn|WithdrawnWithFee:balance:
+//	LOGOUT:								OK:
+//	QUIT:								OK: and the connection is closed
+//
+// Anything else is answered with ERROR:reason:. Account changes hold the account's lock from lockSaving or lockChecking,
+// so sessions on different accounts never wait on each other. Clients cannot stop the server; runServer returns once
+// SIGINT or SIGTERM has stopped it and every session has finished the request it was answering.
+bool runServer(accountStore& _store, unsigned short _port);
@@ -0,0 +1,428 @@
+#include "statementWriter.h"
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	const int64_t secondsPerDay = 86400;
+
+	// daysFromCivil function returns the number of days from 1970-01-01 to the date, for any proleptic Gregorian date
+	int64_t daysFromCivil(int64_t _year, unsigned _month, unsigned _day)
+	{
+		_year -= _month <= 2;
+		int64_t era = (_year >= 0 ? _year : _year - 399) / 400;
+		unsigned yearOfEra = static_cast<unsigned>(_year - era * 400);
+		unsigned dayOfYear = (153 * (_month + (_month > 2 ? -3 : 9)) + 2) / 5 + _day - 1;
+		unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+		return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+	}
+
+	// civilFromDays function is the inverse of daysFromCivil
+	void civilFromDays(int64_t _days, int64_t& _year, unsigned& _month, unsigned& _day)
+	{
+		_days += 719468;
+		int64_t era = (_days >= 0 ? _days : _days - 146096) / 146097;
+		unsigned dayOfEra = static_cast<unsigned>(_days - era * 146097);
+		unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+		unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+		unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+		_day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+		_month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+		_year = static_cast<int64_t>(yearOfEra) + era * 400 + (_month <= 2);
+	}
+
+	// putDigits function writes _value as exactly _width digits, padded with leading zeros
+	char* putDigits(char* _next, int64_t _value, int _width)
+	{
+		for (int digit = _width - 1; digit >= 0; digit--)
+		{
+			_next[digit] = static_cast<char>('0' + _value % 10);
+			_value /= 10;
+		}
+		return _next + _width;
+	}
+
+	// formatDate function writes the UTC date of a timestamp as YYYY-MM-DD, and the time as HH:MM:SS after it if _withTime
+	char* formatDate(char* _next, int64_t _timestamp, bool _withTime)
+	{
+		int64_t days = _timestamp / secondsPerDay;
+		int64_t seconds = _timestamp % secondsPerDay;
+		if (seconds < 0)
+		{
+			days--;
+			seconds += secondsPerDay;
+		}
+		int64_t year;
+		unsigned month, day;
+		civilFromDays(days, year, month, day);
+
+		_next = putDigits(_next, year, 4);
+		*_next++ = '-';
+		_next = putDigits(_next, month, 2);
+		*_next++ = '-';
+		_next = putDigits(_next, day, 2);
+		if (_withTime)
+		{
+			*_next++ = ' ';
+			_next = putDigits(_next, seconds / 3600, 2);
+			*_next++ = ':';
+			_next = putDigits(_next, seconds / 60 % 60, 2);
+			*_next++ = ':';
+			_next = putDigits(_next, seconds % 60, 2);
+		}
+		return _next;
+	}
+
+	// entryName function returns the word a statement shows for a ledger entry type
+	const char* entryName(ledgerEntryType _type)
+	{
+		switch (_type)
+		{
+		case LEDGER_DEPOSIT:
+			return "Deposit";
+		case LEDGER_WITHDRAWAL:
+			return "Withdrawal";
+		case LEDGER_OVERDRAFT_FEE:
+			return "Overdraft fee";
+		default:
+			return "Interest";
+		}
+	}
+
+	// StatementBuffer class declaration
+	//
+	// Gathers statement text and writes it to the stream whenever flushSize bytes have built up, even partway through a
+	// statement, so a statement costs a few large writes instead of one per field and never holds more than a page of text.
+	// Because the start of a statement may already be written, one whose history cannot be read is ended with a
+	// truncation line instead of being taken back.
+	class statementBuffer
+	{
+	public:
+		statementBuffer(std::ostream& _out) : out(_out)
+		{
+			text.reserve(flushSize + 256);
+			truncated = 0;
+		}
+
+		// truncateStatement function ends the current statement with a line saying the rest of it could not be read
+		void truncateStatement()
+		{
+			append("*** Statement truncated: the account history could not be read ***");
+			endLine();
+			endLine();
+			truncated++;
+		}
+
+		// gettruncated function returns the number of statements ended by truncateStatement
+		size_t gettruncated() const
+		{
+			return truncated;
+		}
+
+		// flushed function returns false once a write to the stream has failed
+		bool flushed() const
+		{
+			return out.good();
+		}
+
+		void append(std::string_view _text)
+		{
+			text.append(_text.data(), _text.size());
+		}
+
+		// appendMoney function appends an amount right-aligned in a column of _width characters
+		void appendMoney(money _amount, size_t _width)
+		{
+			char digits[formattedChars];
+			size_t length = static_cast<size_t>(_amount.toChars(digits, digits + sizeof(digits)) - digits);
+			if (length < _width)
+			{
+				text.append(_width - length, ' ');
+			}
+			text.append(digits, length);
+		}
+
+		// appendPadded function appends text left-aligned in a column of _width characters
+		void appendPadded(std::string_view _text, size_t _width)
+		{
+			append(_text);
+			if (_text.size() < _width)
+			{
+				text.append(_width - _text.size(), ' ');
+			}
+		}
+
+		void appendDate(int64_t _timestamp, bool _withTime)
+		{
+			char date[32];
+			append(std::string_view(date, static_cast<size_t>(formatDate(date, _timestamp, _withTime) - date)));
+		}
+
+		void appendNumber(int64_t _number)
+		{
+			char digits[24];
+			append(std::string_view(digits, static_cast<size_t>(std::to_chars(digits, digits + sizeof(digits), _number).ptr - digits)));
+		}
+
+		// endLine function ends a line and writes the buffer out once it is full
+		// A failed write leaves the stream failed, so the next flush reports it
+		void endLine()
+		{
+			text.push_back('\n');
+			if (text.size() >= flushSize)
+			{
+				flush();
+			}
+		}
+
+		bool flush()
+		{
+			if (text.empty() == false)
+			{
+				out.write(text.data(), static_cast<std::streamsize>(text.size()));
+				text.clear();
+			}
+			return out.good();
+		}
+
+		static const size_t flushSize = 65536;
+
+	private:
+		std::ostream& out;
+		std::string text;
+		size_t truncated;
+	};
+
+	// openingBalance function returns the account's balance at the start of the period: the balance left by its last entry
+	// before the period, or the balance before its first entry from then on, or its current balance if it has no entries
+	bool openingBalance(const accountLedger& _ledger, int _id, int64_t _from, money _current, money& _balance)
+	{
+		ledgerEntry entry;
+		if (_ledger.lastBefore(_id, _from, entry))
+		{
+			_balance = entry.balance;
+			return true;
+		}
+		_balance = _current;
+		return _ledger.scan(_id, _from, INT64_MAX, [&_balance](const ledgerEntry& _entry)
+			{
+				_balance = _entry.balance - balanceChange(_entry);
+				return false;
+			});
+	}
+
+	// writeStatementTo function writes one account's statement into _buffer
+	// Returns false if no account has the id, a ledger block could not be read or the output failed;
+	// a statement whose entries could not all be read is ended with a truncation line
+	bool writeStatementTo(const accountStore& _store, int _id, int64_t _from, int64_t _to, statementBuffer& _buffer)
+	{
+		savingAccount idSaving;
+		checkingAccount idChecking;
+		const account* idAccount = &idSaving;
+		const char* type = "Saving";
+		if (_store.findSavingById(_id, idSaving) == false)
+		{
+			if (_store.findCheckingById(_id, idChecking) == false)
+			{
+				return false;
+			}
+			idAccount = &idChecking;
+			type = "Checking";
+		}
+
+		const customer& holder = idAccount->getaccountCustomer();
+		_buffer.append("Statement for account ");
+		_buffer.appendNumber(_id);
+		_buffer.append(" (");
+		_buffer.append(type);
+		_buffer.append(")");
+		_buffer.endLine();
+		_buffer.append("Customer: ");
+		_buffer.append(holder.getfirstName());
+		_buffer.append(" ");
+		_buffer.append(holder.getlastName());
+		_buffer.append(" (");
+		_buffer.append(holder.getusername());
+		_buffer.append(")");
+		_buffer.endLine();
+		_buffer.append("Period: ");
+		_buffer.appendDate(_from, false);
+		_buffer.append(" to ");
+		_buffer.appendDate(_to, false);
+		_buffer.endLine();
+
+		money balance;
+		if (openingBalance(_store.getledger(), _id, _from, idAccount->getbalance(), balance) == false)
+		{
+			_buffer.truncateStatement();
+			return false;
+		}
+		_buffer.appendPadded("Opening balance:", 36);
+		_buffer.appendMoney(balance, 14);
+		_buffer.endLine();
+		_buffer.appendPadded("Date", 21);
+		_buffer.appendPadded("Type", 15);
+		_buffer.append("        Amount       Balance");
+		_buffer.endLine();
+
+		money credits, debits;
+		size_t transactions = 0;
+		bool scanned = _store.getledger().scan(_id, _from, _to, [&](const ledgerEntry& _entry)
+			{
+				money change = balanceChange(_entry);
+				if (change < money())
+				{
+					debits -= change;
+				}
+				else
+				{
+					credits += change;
+				}
+				balance = _entry.balance;
+				transactions++;
+
+				_buffer.appendDate(_entry.timestamp, true);
+				_buffer.append("  ");
+				_buffer.appendPadded(entryName(_entry.type), 15);
+				_buffer.appendMoney(change, 14);
+				_buffer.appendMoney(_entry.balance, 14);
+				_buffer.endLine();
+				return true;
+			});
+		if (scanned == false)
+		{
+			_buffer.truncateStatement();
+			return false;
+		}
+
+		_buffer.appendPadded("Closing balance:", 36);
+		_buffer.appendMoney(balance, 14);
+		_buffer.endLine();
+		_buffer.appendPadded("Credits:", 36);
+		_buffer.appendMoney(credits, 14);
+		_buffer.endLine();
+		_buffer.appendPadded("Debits:", 36);
+		_buffer.appendMoney(debits, 14);
+		_buffer.endLine();
+		_buffer.append("Transactions: ");
+		_buffer.appendNumber(static_cast<int64_t>(transactions));
+		_buffer.endLine();
+		_buffer.endLine();
+		return _buffer.flushed();
+	}
+}
+
+#pragma region Statement Functions
+// parseStatementDate function reads a YYYY-MM-DD date as the timestamp of its first second, or of its last if _endOfDay
+// Returns false if the text is not a valid date
+bool parseStatementDate(std::string_view _text, bool _endOfDay, int64_t& _timestamp)
+{
+	int year = 0;
+	unsigned month = 0, day = 0;
+	const char* end = _text.data() + _text.size();
+	std::from_chars_result parsed = std::from_chars(_text.data(), end, year);
+	if (parsed.ec != std::errc() || parsed.ptr == end || *parsed.ptr != '-')
+	{
+		return false;
+	}
+	parsed = std::from_chars(parsed.ptr + 1, end, month);
+	if (parsed.ec != std::errc() || parsed.ptr == end || *parsed.ptr != '-')
+	{
+		return false;
+	}
+	parsed = std::from_chars(parsed.ptr + 1, end, day);
+	if (parsed.ec != std::errc() || parsed.ptr != end || month < 1 || month > 12 || day < 1)
+	{
+		return false;
+	}
+
+	// A day past the end of the month comes back as a different date
+	int64_t days = daysFromCivil(year, month, day);
+	int64_t checkYear;
+	unsigned checkMonth, checkDay;
+	civilFromDays(days, checkYear, checkMonth, checkDay);
+	if (checkYear != year || checkMonth != month || checkDay != day)
+	{
+		return false;
+	}
+	_timestamp = days * secondsPerDay + (_endOfDay ? secondsPerDay - 1 : 0);
+	return true;
+}
+
+// writeStatement function writes the statement of the account with the id for the period from _from to _to inclusive
+// Returns false if no account has the id or the statement could not be read or written
+bool writeStatement(const accountStore& _store, int _id, int64_t _from, int64_t _to, std::ostream& _out)
+{
+	statementBuffer buffer(_out);
+	bool written = writeStatementTo(_store, _id, _from, _to, buffer);
+	return buffer.flush() && written;
+}
+
+// writeStatements function writes the statement of every account for the period into _directory, splitting the accounts
+// into one contiguous partition per thread; worker n writes its statements to statements_n.txt
+// Returns the number of statements written in _statements, or false if a file could not be written or a statement
+// was truncated because its history could not be read
+bool writeStatements(const accountStore& _store, int64_t _from, int64_t _to, const std::string& _directory, unsigned _threads, size_t& _statements)
+{
+	std::error_code error;
+	std::filesystem::create_directories(_directory, error);
+	if (error)
+	{
+		return false;
+	}
+
+	accountTable table;
+	_store.fillTable(table);
+	std::vector<int> ids;
+	ids.reserve(table.getaccountCount());
+	ids.insert(ids.end(), table.getsavings().ids.begin(), table.getsavings().ids.end());
+	ids.insert(ids.end(), table.getcheckings().ids.begin(), table.getcheckings().ids.end());
+
+	unsigned threads = std::max(1u, _threads);
+	size_t partitionSize = (ids.size() + threads - 1) / threads;
+	std::vector<size_t> written(threads, 0);
+	std::vector<char> succeeded(threads, 1);
+	std::vector<std::thread> workers;
+	for (unsigned worker = 0; worker < threads && worker * partitionSize < ids.size(); worker++)
+	{
+		workers.emplace_back([&, worker]()
+			{
+				std::ofstream out(_directory + "/statements_" + std::to_string(worker + 1) + ".txt", std::ios::out | std::ios::trunc | std::ios::binary);
+				statementBuffer buffer(out);
+				size_t end = std::min(ids.size(), (worker + 1) * partitionSize);
+				for (size_t i = worker * partitionSize; i < end; i++)
+				{
+					// An account closed since the table was filled has no statement
+					if (writeStatementTo(_store, ids[i], _from, _to, buffer))
+					{
+						written[worker]++;
+					}
+					else if (buffer.flushed() == false)
+					{
+						break;
+					}
+				}
+				if (buffer.flush() == false || buffer.gettruncated() != 0)
+				{
+					succeeded[worker] = 0;
+				}
+			});
+	}
+	for (std::thread& workerThread : workers)
+	{
+		workerThread.join();
+	}
+
+	_statements = 0;
+	for (size_t count : written)
+	{
+		_statements += count;
+	}
+	return std::find(succeeded.begin(), succeeded.end(), 0) == succeeded.end();
+}
+#pragma endregion
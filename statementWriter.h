@@ -0,0 +1,21 @@
+#pragma once
+#include "accountStore.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// Statement functions
+//
+// A statement lists an account's ledger entries for a period, oldest first, each with the balance it left, between
+// the opening and closing balance and followed by the period's credit and debit totals. The entries are streamed from
+// the ledger one block at a time and the text is gathered in a buffer written out in large pieces, so a statement over
+// years of history never holds that history in memory. A statement whose history cannot be read partway through is
+// ended with a truncation line and reported as a failure, since its start may already be written.
+//
+// Periods run from the start of the first day to the end of the last, in UTC. writeStatements writes every account's
+// statement for month-end, splitting the accounts across worker threads that each write their own file.
+bool parseStatementDate(std::string_view _text, bool _endOfDay, int64_t& _timestamp);
+bool writeStatement(const accountStore& _store, int _id, int64_t _from, int64_t _to, std::ostream& _out);
+bool writeStatements(const accountStore& _store, int64_t _from, int64_t _to, const std::string& _directory, unsigned _threads, size_t& _statements);
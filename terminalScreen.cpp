@@ -0,0 +1,200 @@
+#include "terminalScreen.h"
+#include <cstdio>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <conio.h>
+#include <io.h>
+#else
+#include <cerrno>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// Moves the cursor to the top left corner and erases the display
+	const char clearSequence[] = "\x1b[H\x1b[2J";
+
+	bool outputIsTerminal()
+	{
+#ifdef _WIN32
+		static const bool terminal = _isatty(_fileno(stdout)) != 0;
+#else
+		static const bool terminal = isatty(STDOUT_FILENO) != 0;
+#endif
+		return terminal;
+	}
+
+	bool inputIsTerminal()
+	{
+#ifdef _WIN32
+		static const bool terminal = _isatty(_fileno(stdin)) != 0;
+#else
+		static const bool terminal = isatty(STDIN_FILENO) != 0;
+#endif
+		return terminal;
+	}
+
+	// writeAll function writes _count bytes to standard output, retrying short writes
+	bool writeAll(const char* _text, size_t _count)
+	{
+		while (_count > 0)
+		{
+#ifdef _WIN32
+			int written = _write(_fileno(stdout), _text, static_cast<unsigned>(_count));
+			if (written <= 0)
+			{
+				return false;
+			}
+#else
+			ssize_t written = ::write(STDOUT_FILENO, _text, _count);
+			if (written < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (written <= 0)
+			{
+				return false;
+			}
+#endif
+			_text += written;
+			_count -= static_cast<size_t>(written);
+		}
+		return true;
+	}
+}
+
+#pragma region Frame Buffer Class Implementation
+// Frame
+
+// present function writes the gathered frame to the terminal in one call and starts an empty one
+bool frameBuffer::present()
+{
+	if (frame.empty())
+	{
+		return true;
+	}
+	bool written = writeAll(frame.data(), frame.size());
+	frame.clear();
+	return written;
+}
+
+frameBuffer::int_type frameBuffer::overflow(int_type _character)
+{
+	if (traits_type::eq_int_type(_character, traits_type::eof()) == false)
+	{
+		frame.push_back(traits_type::to_char_type(_character));
+	}
+	return traits_type::not_eof(_character);
+}
+
+std::streamsize frameBuffer::xsputn(const char* _text, std::streamsize _count)
+{
+	frame.append(_text, static_cast<size_t>(_count));
+	return _count;
+}
+
+int frameBuffer::sync()
+{
+	return present() ? 0 : -1;
+}
+#pragma endregion
+
+#pragma region Terminal Screen Class Implementation
+// Constructors, used for terminal screen creation
+// Windows consoles only interpret escape sequences once virtual terminal processing is turned on
+terminalScreen::terminalScreen()
+{
+#ifdef _WIN32
+	HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+	DWORD mode = 0;
+	if (console != INVALID_HANDLE_VALUE && GetConsoleMode(console, &mode))
+	{
+		SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+	}
+#endif
+	std::cout.flush();
+	previous = std::cout.rdbuf(&buffer);
+}
+
+// Destructor presents whatever is left of the last screen and gives std::cout its own buffer back
+terminalScreen::~terminalScreen()
+{
+	buffer.present();
+	std::cout.rdbuf(previous);
+}
+#pragma endregion
+
+#pragma region Screen Functions
+void clearScreen()
+{
+	if (outputIsTerminal())
+	{
+		std::cout << clearSequence;
+	}
+	else
+	{
+		std::cout << "\n";
+	}
+}
+
+void pauseScreen()
+{
+	std::cout << "Press any key to continue . . . ";
+	readKey();
+	std::cout << "\n";
+}
+
+// readKey function presents the screen, then reads one key without waiting for Enter and without echoing it
+int readKey()
+{
+	std::cout.flush();
+	if (inputIsTerminal())
+	{
+#ifdef _WIN32
+		int key = _getch();
+		if (key == 0 || key == 0xE0)
+		{
+			// Arrow and function keys arrive as a prefix followed by their code
+			return 256 + _getch();
+		}
+		return key == '\r' ? '\n' : key;
+#else
+		termios saved;
+		if (tcgetattr(STDIN_FILENO, &saved) == 0)
+		{
+			termios raw = saved;
+			raw.c_lflag &= ~(ICANON | ECHO);
+			raw.c_cc[VMIN] = 1;
+			raw.c_cc[VTIME] = 0;
+			tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+			int key = std::cin.get();
+			tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+			return key;
+		}
+#endif
+	}
+
+	std::string line;
+	if (!std::getline(std::cin, line))
+	{
+		return EOF;
+	}
+	return line.empty() ? '\n' : static_cast<unsigned char>(line[0]);
+}
+
+bool readMenuKey(int& _selection)
+{
+	int key = readKey();
+	if (key < '0' || key > '9')
+	{
+		return false;
+	}
+	_selection = key - '0';
+	return true;
+}
+#pragma endregion
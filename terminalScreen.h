@@ -0,0 +1,54 @@
+#pragma once
+#include <streambuf>
+#include <string>
+
+// FrameBuffer class declaration
+//
+// A stream buffer that gathers everything written to it and hands it to the terminal in a single write when the
+// stream is flushed, so a whole screen appears at once instead of line by line.
+class frameBuffer : public std::streambuf
+{
+public:
+	// Frame
+	bool present();
+
+protected:
+	int_type overflow(int_type _character) override;
+	std::streamsize xsputn(const char* _text, std::streamsize _count) override;
+	int sync() override;
+
+private:
+	// Attributes
+	std::string frame;
+};
+
+// TerminalScreen class declaration
+//
+// While a terminalScreen exists, std::cout writes into its frame and the frame is presented whenever std::cin is about
+// to wait for input, because std::cin flushes std::cout first. Screens are cleared with escape sequences rather than by
+// starting a shell for "cls", and menu keys are read as soon as they are pressed. Escape sequences are only written
+// when the output is a terminal, so the menus stay readable when redirected.
+class terminalScreen
+{
+public:
+	// Constructors
+	terminalScreen();
+	~terminalScreen();
+	terminalScreen(const terminalScreen&) = delete;
+	terminalScreen& operator=(const terminalScreen&) = delete;
+
+private:
+	// Attributes
+	frameBuffer buffer;
+	std::streambuf* previous;
+};
+
+// Screen functions
+//
+// clearScreen starts a new screen, pauseScreen waits for any key, readKey returns one keypress (EOF at the end of
+// input) and readMenuKey reads a menu selection from a single digit key. Input that is not a terminal is read a line
+// at a time, so a script answers each prompt on its own line.
+void clearScreen();
+void pauseScreen();
+int readKey();
+bool readMenuKey(int& _selection);
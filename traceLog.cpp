@@ -0,0 +1,142 @@
+#include "traceLog.h"
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	std::atomic<bool> tracing(false);
+	std::mutex eventsMutex;
+	std::vector<traceEvent> events;
+	std::chrono::steady_clock::time_point origin;
+	std::atomic<uint32_t> nextThread(1);
+
+	// threadNumber function returns a small number for the calling thread, given out in the order threads first trace
+	uint32_t threadNumber()
+	{
+		thread_local uint32_t number = nextThread.fetch_add(1);
+		return number;
+	}
+
+	// writeMicroseconds function writes a duration in nanoseconds as the microseconds trace events count in
+	void writeMicroseconds(std::ostream& _out, int64_t _nanoseconds)
+	{
+		_out << _nanoseconds / 1000 << "." << std::setw(3) << std::setfill('0') << _nanoseconds % 1000 << std::setfill(' ');
+	}
+}
+
+#pragma region Trace Span Class Implementation
+// Constructors, used for trace span creation
+traceSpan::traceSpan(const char* _name, const char* _category)
+{
+	active = tracing.load(std::memory_order_relaxed);
+	name = _name;
+	category = _category;
+	argumentName = nullptr;
+	argumentValue = 0;
+	if (active)
+	{
+		start = std::chrono::steady_clock::now();
+	}
+}
+
+// Destructor records the finished span, unless tracing was off when it started
+traceSpan::~traceSpan()
+{
+	if (active == false)
+	{
+		return;
+	}
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	traceEvent event;
+	event.name = name;
+	event.category = category;
+	event.durationNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	event.thread = threadNumber();
+	event.argumentName = argumentName;
+	event.argumentValue = argumentValue;
+
+	std::lock_guard<std::mutex> eventsLock(eventsMutex);
+	if (tracing.load(std::memory_order_relaxed))
+	{
+		event.startNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin).count();
+		events.push_back(event);
+	}
+}
+
+// Setters, used for setting specific private attributes
+void traceSpan::setargument(const char* _argumentName, int64_t _argumentValue)
+{
+	argumentName = _argumentName;
+	argumentValue = _argumentValue;
+}
+#pragma endregion
+
+#pragma region Trace Session Class Implementation
+// Constructors, used for trace session creation
+traceSession::traceSession(std::string _path)
+{
+	path = std::move(_path);
+	if (path != "")
+	{
+		startTracing();
+	}
+}
+
+traceSession::~traceSession()
+{
+	if (path != "" && stopTracing(path) == false)
+	{
+		std::cout << "ERROR: File handling\n";
+	}
+}
+#pragma endregion
+
+#pragma region Trace Functions
+void startTracing()
+{
+	std::lock_guard<std::mutex> eventsLock(eventsMutex);
+	events.clear();
+	events.reserve(4096);
+	origin = std::chrono::steady_clock::now();
+	tracing.store(true);
+}
+
+bool stopTracing(const std::string& _path)
+{
+	std::vector<traceEvent> finished;
+	{
+		std::lock_guard<std::mutex> eventsLock(eventsMutex);
+		tracing.store(false);
+		finished.swap(events);
+	}
+
+	std::ofstream traceFile(_path, std::ios::out | std::ios::trunc);
+	traceFile << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+	traceFile << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"ClientBankingInterface\"}}";
+	for (const traceEvent& event : finished)
+	{
+		traceFile << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category << "\",\"ph\":\"X\",\"ts\":";
+		writeMicroseconds(traceFile, event.startNanoseconds);
+		traceFile << ",\"dur\":";
+		writeMicroseconds(traceFile, event.durationNanoseconds);
+		traceFile << ",\"pid\":1,\"tid\":" << event.thread;
+		if (event.argumentName != nullptr)
+		{
+			traceFile << ",\"args\":{\"" << event.argumentName << "\":" << event.argumentValue << "}";
+		}
+		traceFile << "}";
+	}
+	traceFile << "\n]}\n";
+	traceFile.close();
+	return traceFile.good();
+}
+
+bool isTracing()
+{
+	return tracing.load(std::memory_order_relaxed);
+}
+#pragma endregion
@@ -0,0 +1,70 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// traceEvent: one finished span, kept in memory until the trace is written
+// name, category and argumentName are string literals; argumentName is nullptr when the span has no argument
+struct traceEvent
+{
+	const char* name;
+	const char* category;
+	int64_t startNanoseconds;
+	int64_t durationNanoseconds;
+	uint32_t thread;
+	const char* argumentName;
+	int64_t argumentValue;
+};
+
+// TraceSpan class declaration
+//
+// Times the scope it is declared in as one span of the trace. While tracing is off a span only reads one flag, so
+// spans stay compiled into the persistence code at no real cost. A span can carry one numeric argument, such as the
+// number of records it read, which trace viewers show next to it.
+class traceSpan
+{
+public:
+	// Constructors
+	traceSpan(const char* _name, const char* _category);
+	~traceSpan();
+	traceSpan(const traceSpan&) = delete;
+	traceSpan& operator=(const traceSpan&) = delete;
+
+	// Setters
+	void setargument(const char* _argumentName, int64_t _argumentValue);
+
+private:
+	// Attributes
+	bool active;
+	const char* name;
+	const char* category;
+	const char* argumentName;
+	int64_t argumentValue;
+	std::chrono::steady_clock::time_point start;
+};
+
+// TraceSession class declaration
+//
+// Turns tracing on for its lifetime when given a path, and on destruction writes every span recorded meanwhile to
+// the path as Chrome trace-event JSON, which chrome://tracing and Perfetto open. An empty path leaves tracing off.
+class traceSession
+{
+public:
+	// Constructors
+	explicit traceSession(std::string _path);
+	~traceSession();
+	traceSession(const traceSession&) = delete;
+	traceSession& operator=(const traceSession&) = delete;
+
+private:
+	// Attributes
+	std::string path;
+};
+
+// Trace functions
+//
+// startTracing forgets earlier spans and starts recording; stopTracing stops and writes the spans to _path,
+// returning false if the file could not be written.
+void startTracing();
+bool stopTracing(const std::string& _path);
+bool isTracing();
@@ -1,4 +1,138 @@
 #include "UserClasses.h"
+#include "operationMetrics.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+
+namespace
+{
+	// blankCustomer function returns the shared profile used by accounts without a customer, created once
+	const customerHandle& blankCustomer()
+	{
+		static const customerHandle blank = std::make_shared<const customer>();
+		return blank;
+	}
+
+	// spareEntries function returns the calling thread's spare pending entry buffer
+	// An account without a buffer of its own borrows it for its first entry and hands it back once the store has
+	// recorded the entries, so a session that deposits and writes the account back reuses one buffer instead of
+	// allocating a new one for every fresh copy of an account
+	std::vector<ledgerEntry>& spareEntries()
+	{
+		thread_local std::vector<ledgerEntry> spare;
+		return spare;
+	}
+
+	// multiplyWide function returns the 128 bit product of _a and _b as a high and a low word, built from 32 bit halves
+	// so every compiler gets the same result
+	void multiplyWide(uint64_t _a, uint64_t _b, uint64_t& _high, uint64_t& _low)
+	{
+		const uint64_t lowHalf = 0xFFFFFFFF;
+		uint64_t lowLow = (_a & lowHalf) * (_b & lowHalf);
+		uint64_t lowHigh = (_a & lowHalf) * (_b >> 32);
+		uint64_t highLow = (_a >> 32) * (_b & lowHalf);
+		uint64_t middle = (lowLow >> 32) + (lowHigh & lowHalf) + (highLow & lowHalf);
+		_low = (lowLow & lowHalf) | (middle << 32);
+		_high = (_a >> 32) * (_b >> 32) + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+	}
+
+	// mulShift function returns _a * _b / 2^_shift rounded to the nearest integer with halves up, for _shift from 1 to 63,
+	// or UINT64_MAX if that does not fit in 64 bits
+	uint64_t mulShift(uint64_t _a, uint64_t _b, int _shift)
+	{
+		uint64_t high, low;
+		multiplyWide(_a, _b, high, low);
+		uint64_t half = uint64_t(1) << (_shift - 1);
+		low += half;
+		high += low < half ? 1 : 0;
+		if ((high >> _shift) != 0)
+		{
+			return UINT64_MAX;
+		}
+		return (high << (64 - _shift)) | (low >> _shift);
+	}
+
+	// mulDivide function returns _a * _b / _divisor rounded to the nearest integer with halves up, for a _divisor below
+	// 2^48, or UINT64_MAX if that does not fit in 64 bits; the 128 bit product is divided 16 bits at a time
+	uint64_t mulDivide(uint64_t _a, uint64_t _b, uint64_t _divisor)
+	{
+		uint64_t high, low;
+		multiplyWide(_a, _b, high, low);
+		uint64_t half = _divisor / 2;
+		low += half;
+		high += low < half ? 1 : 0;
+		if (high >= _divisor)
+		{
+			return UINT64_MAX;
+		}
+
+		uint64_t quotient = 0;
+		uint64_t remainder = high;
+		for (int shift = 48; shift >= 0; shift -= 16)
+		{
+			remainder = (remainder << 16) | ((low >> shift) & 0xFFFF);
+			quotient = (quotient << 16) | (remainder / _divisor);
+			remainder %= _divisor;
+		}
+		return quotient;
+	}
+
+	// compoundGrowth function sets _growth to (1 + rate / 365)^_days in units of 2^-_shift, raising the daily factor to
+	// the power by repeated squaring, and returns false if the growth does not fit in 64 bits at that precision
+	bool compoundGrowth(fixedRate _yearlyRate, int64_t _days, int _shift, uint64_t& _growth)
+	{
+		const uint64_t one = uint64_t(1) << _shift;
+		int64_t rate = _yearlyRate.getmillionths();
+		uint64_t dailyChange = std::min(one, mulDivide(rate < 0 ? 0 - static_cast<uint64_t>(rate) : static_cast<uint64_t>(rate), one,
+			static_cast<uint64_t>(fixedRate::scale) * savingAccount::daysPerYear));
+		uint64_t base = rate < 0 ? one - dailyChange : one + dailyChange;
+		_growth = one;
+		for (int64_t days = _days; days > 0; days >>= 1)
+		{
+			if ((days & 1) != 0)
+			{
+				_growth = mulShift(_growth, base, _shift);
+			}
+			if (days > 1)
+			{
+				// A square that does not fit means the growth would not fit either
+				base = mulShift(base, base, _shift);
+			}
+			if (_growth == UINT64_MAX || base == UINT64_MAX)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// dailyCompoundInterest function returns the interest _balance earns over _days at a yearly rate compounded daily,
+	// balance * ((1 + rate / 365)^days - 1), rounded once to the nearest cent with halves away from zero
+	// The growth is computed in integers only, in units of 2^-60 while it stays below 16, which keeps the interest within
+	// a cent of exact arithmetic on balances of up to a billion dollars over ten years; a larger growth is computed with
+	// as many fractional bits as still fit
+	money dailyCompoundInterest(money _balance, fixedRate _yearlyRate, int64_t _days)
+	{
+		int shift = 60;
+		uint64_t growth = 0;
+		while (compoundGrowth(_yearlyRate, _days, shift, growth) == false)
+		{
+			shift -= 4;
+			if (shift == 0)
+			{
+				return money::fromCents(_balance < money() ? INT64_MIN + 1 : INT64_MAX);
+			}
+		}
+
+		const uint64_t one = uint64_t(1) << shift;
+		int64_t cents = _balance.getcents();
+		uint64_t magnitude = cents < 0 ? 0 - static_cast<uint64_t>(cents) : static_cast<uint64_t>(cents);
+		bool shrinks = growth < one;
+		uint64_t interest = std::min<uint64_t>(mulShift(magnitude, shrinks ? one - growth : growth - one, shift), INT64_MAX);
+		return money::fromCents((cents < 0) != shrinks ? -static_cast<int64_t>(interest) : static_cast<int64_t>(interest));
+	}
+}
 
 #pragma region Customer Class Implementation
 // Constructors, used for customer class creation
@@ -14,72 +148,72 @@ customer::customer()
 
 customer::customer(std::string _firstName, std::string _lastName, std::string _address, std::string _phoneNum, std::string _email, std::string _username)
 {
-	firstName = _firstName;
-	lastName = _lastName;
-	address = _address;
-	phoneNum = _phoneNum;
-	email = _email;
-	username = _username;
+	firstName = std::move(_firstName);
+	lastName = std::move(_lastName);
+	address = std::move(_address);
+	phoneNum = std::move(_phoneNum);
+	email = std::move(_email);
+	username = std::move(_username);
 }
 
 // Setters, used for setting specific private attributes
 void customer::setfirstName(std::string _firstName)
 {
-	firstName = _firstName;
+	firstName = std::move(_firstName);
 }
 
 void customer::setlastName(std::string _lastName)
 {
-	lastName = _lastName;
+	lastName = std::move(_lastName);
 }
 
 void customer::setaddress(std::string _address)
 {
-	address = _address;
+	address = std::move(_address);
 }
 
 void customer::setphoneNum(std::string _phoneNum)
 {
-	phoneNum = _phoneNum;
+	phoneNum = std::move(_phoneNum);
 }
 
 void customer::setemail(std::string _email)
 {
-	email = _email;
+	email = std::move(_email);
 }
 
 void customer::setusername(std::string _username)
 {
-	username = _username;
+	username = std::move(_username);
 }
 
 // Getters, used for returning specific private attributes
-std::string customer::getfirstName() const
+const std::string& customer::getfirstName() const
 {
 	return firstName;
 }
 
-std::string customer::getlastName() const
+const std::string& customer::getlastName() const
 {
 	return lastName;
 }
 
-std::string customer::getaddress() const
+const std::string& customer::getaddress() const
 {
 	return address;
 }
 
-std::string customer::getphoneNum() const
+const std::string& customer::getphoneNum() const
 {
 	return phoneNum;
 }
 
-std::string customer::getemail() const
+const std::string& customer::getemail() const
 {
 	return email;
 }
 
-std::string customer::getusername() const
+const std::string& customer::getusername() const
 {
 	return username;
 }
@@ -102,16 +236,16 @@ void customer::printInfo() const
 // Constructors, used for account class creation
 account::account()
 {
-	accountCustomer = customer();
-	balance = 0.0;
+	accountCustomer = blankCustomer();
+	balance = money();
 	id = 0;
 	depositCount = 0;
 	withdrawalCount = 0;
 }
 
-account::account(customer _accountCustomer, float _balance, int _id, int _depositCount, int _withdrawalCount)
+account::account(customerHandle _accountCustomer, money _balance, int _id, int _depositCount, int _withdrawalCount)
 {
-	accountCustomer = customer(_accountCustomer);
+	setaccountCustomer(std::move(_accountCustomer));
 	balance = _balance;
 	id = _id;
 	depositCount = _depositCount;
@@ -119,12 +253,17 @@ account::account(customer _accountCustomer, float _balance, int _id, int _deposi
 }
 
 // Setters, used for setting specific private attributes
-void account::setaccountCustomer(customer _accountCustomer)
+void account::setaccountCustomer(customerHandle _accountCustomer)
 {
-	accountCustomer = customer(_accountCustomer);
+	if (_accountCustomer == nullptr)
+	{
+		accountCustomer = blankCustomer();
+		return;
+	}
+	accountCustomer = std::move(_accountCustomer);
 }
 
-void account::setbalance(float _balance)
+void account::setbalance(money _balance)
 {
 	balance = _balance;
 }
@@ -145,12 +284,17 @@ void account::setwithdrawalCount(int _withdrawalCount)
 }
 
 // Getters, used for returning a specific private attribute
-customer account::getaccountCustomer() const
+const customer& account::getaccountCustomer() const
+{
+	return *accountCustomer;
+}
+
+const customerHandle& account::getcustomerHandle() const
 {
 	return accountCustomer;
 }
 
-float account::getbalance() const
+money account::getbalance() const
 {
 	return balance;
 }
@@ -170,12 +314,17 @@ int account::getwithdrawalCount() const
 	return withdrawalCount;
 }
 
+const std::vector<ledgerEntry>& account::getpendingEntries() const
+{
+	return pendingEntries;
+}
+
 // Other functions
 
 // printInfo function prints attributes of account class
 void account::printInfo() const
 {
-	accountCustomer.printInfo();
+	accountCustomer->printInfo();
 	std::cout << std::setw(30) << std::left << "Balance:" << balance << "\n";
 	std::cout << std::setw(30) << std::left << "ID:" << id << "\n";
 	std::cout << std::setw(30) << std::left << "Number of deposits:" << depositCount << "\n";
@@ -183,17 +332,43 @@ void account::printInfo() const
 }
 
 // deposit function add deposit amount parameter to balance and increments deposit count
-void account::deposit(float _depAmount)
+void account::deposit(money _depAmount)
 {
+	operationTimer timer(METRIC_DEPOSIT);
 	balance = balance + _depAmount;
 	depositCount++;
+	recordEntry(LEDGER_DEPOSIT, _depAmount);
 }
 
 // withdrawal function subtracts withdrawal amount parameter to balance and increments withdrawal count
-void account::withdrawal(float _withAmount)
+void account::withdrawal(money _withAmount)
 {
 	balance = balance - _withAmount;
 	withdrawalCount++;
+	recordEntry(LEDGER_WITHDRAWAL, _withAmount);
+}
+
+// clearpendingEntries function forgets the pending ledger entries once the store has recorded them
+// and returns their buffer to the thread's spare, unless the thread already has one
+void account::clearpendingEntries()
+{
+	pendingEntries.clear();
+	std::vector<ledgerEntry>& spare = spareEntries();
+	if (spare.capacity() == 0)
+	{
+		pendingEntries.swap(spare);
+	}
+}
+
+// recordEntry function notes a change just made to the balance, so the store can add it to the account's ledger
+void account::recordEntry(ledgerEntryType _type, money _amount)
+{
+	int64_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	if (pendingEntries.capacity() == 0)
+	{
+		pendingEntries.swap(spareEntries());
+	}
+	pendingEntries.push_back(ledgerEntry{ now, _amount, balance, _type });
 }
 #pragma endregion
 
@@ -201,26 +376,48 @@ void account::withdrawal(float _withAmount)
 // Constructors, used for saving account class creation
 savingAccount::savingAccount() : account()
 {
-	interestRate = 0.0;
+	interestRate = fixedRate();
+	accrualDay = 0;
 }
 
-savingAccount::savingAccount(float _interestRate, customer _accountCustomer, float _balance, int _id, int _depositCount, int _withdrawalCount) : account(_accountCustomer, _balance, _id, _depositCount, _withdrawalCount)
+savingAccount::savingAccount(fixedRate _interestRate, customerHandle _accountCustomer, money _balance, int _id, int _depositCount, int _withdrawalCount) : account(std::move(_accountCustomer), _balance, _id, _depositCount, _withdrawalCount)
 {
 	interestRate = _interestRate;
+	accrualDay = 0;
 }
 
 // Setters, used for setting specific private attributes
-void savingAccount::setinterestRate(float _interestRate)
+void savingAccount::setinterestRate(fixedRate _interestRate)
 {
 	interestRate = _interestRate;
 }
 
+void savingAccount::setaccrualDay(int64_t _accrualDay)
+{
+	accrualDay = _accrualDay;
+}
+
 // Getters, used for returning specific private attributes
-float savingAccount::getinterestRate() const
+fixedRate savingAccount::getinterestRate() const
 {
 	return interestRate;
 }
 
+int64_t savingAccount::getaccrualDay() const
+{
+	return accrualDay;
+}
+
+// getaccruedInterest function returns the interest earned from accrualDay up to _day, without adding it
+money savingAccount::getaccruedInterest(int64_t _day) const
+{
+	if (accrualDay == 0 || _day <= accrualDay)
+	{
+		return money();
+	}
+	return dailyCompoundInterest(getbalance(), interestRate, _day - accrualDay);
+}
+
 // Other functions
 void savingAccount::printInfo() const
 {
@@ -228,10 +425,50 @@ void savingAccount::printInfo() const
 	std::cout << std::setw(30) << std::left << "Interest rate:" << interestRate << "\n";
 }
 
-void savingAccount::payInterest()
+// accrueInterest function adds the interest earned from accrualDay up to _day and moves accrualDay to _day
+// Interest that rounds to nothing leaves no ledger entry
+void savingAccount::accrueInterest(int64_t _day)
+{
+	operationTimer timer(METRIC_ACCRUE_INTEREST);
+	money interest = getaccruedInterest(_day);
+	accrualDay = std::max(accrualDay, _day);
+	if (interest == money())
+	{
+		return;
+	}
+	setbalance(getbalance() + interest);
+	recordEntry(LEDGER_INTEREST, interest);
+}
+
+// currentDay function returns today's day number in UTC, as accrualDay counts days
+int64_t savingAccount::currentDay()
 {
-	float tempBalance = getbalance() * (1 + interestRate);
-	setbalance(tempBalance);
+	return std::chrono::duration_cast<std::chrono::hours>(std::chrono::system_clock::now().time_since_epoch()).count() / 24;
+}
+
+// deposit function accrues the interest earned up to today on the old balance and then deposits the amount
+void savingAccount::deposit(money _depAmount)
+{
+	accrueInterest(currentDay());
+	account::deposit(_depAmount);
+}
+
+// applyWithdrawal function withdraws the amount if it is greater than 0 and the balance, with the interest earned up to
+// today added first, covers it
+withdrawalResult savingAccount::applyWithdrawal(money _withAmount)
+{
+	operationTimer timer(METRIC_WITHDRAWAL);
+	if (_withAmount <= money())
+	{
+		return INVALID_AMOUNT;
+	}
+	accrueInterest(currentDay());
+	if ((getbalance() - _withAmount) < money())
+	{
+		return INSUFFICIENT_BALANCE;
+	}
+	withdrawal(_withAmount);
+	return WITHDRAWN;
 }
 #pragma endregion
 
@@ -239,22 +476,22 @@ void savingAccount::payInterest()
 // Constructors, used for checking account class creation
 checkingAccount::checkingAccount() :account()
 {
-	overdraftLimit = 0.0;
+	overdraftLimit = money();
 }
 
-checkingAccount::checkingAccount(float _overdraftLimit, customer _accountCustomer, float _balance, int _id, int _depositCount, int _withdrawalCount) : account(_accountCustomer, _balance, _id, _depositCount, _withdrawalCount)
+checkingAccount::checkingAccount(money _overdraftLimit, customerHandle _accountCustomer, money _balance, int _id, int _depositCount, int _withdrawalCount) : account(std::move(_accountCustomer), _balance, _id, _depositCount, _withdrawalCount)
 {
 	overdraftLimit = _overdraftLimit;
 }
 
 // Setters, used for setting specific private attributes
-void checkingAccount::setoverdraftLimit(float _overdraftLimit)
+void checkingAccount::setoverdraftLimit(money _overdraftLimit)
 {
 	overdraftLimit = _overdraftLimit;
 }
 
 // Getters, used for returning specific private attributes
-float checkingAccount::getoverdraftLimit() const
+money checkingAccount::getoverdraftLimit() const
 {
 	return overdraftLimit;
 }
@@ -265,4 +502,28 @@ void checkingAccount::printInfo() const
 	account::printInfo();
 	std::cout << std::setw(30) << std::left << "Overdraft limit:" << overdraftLimit << "\n";
 }
+
+// applyWithdrawal function withdraws the amount if it is greater than 0 and the balance covers it,
+// or if the balance stays within the overdraft limit, in which case the overdraft fee is also charged
+withdrawalResult checkingAccount::applyWithdrawal(money _withAmount)
+{
+	operationTimer timer(METRIC_WITHDRAWAL);
+	if (_withAmount <= money())
+	{
+		return INVALID_AMOUNT;
+	}
+	if ((getbalance() - _withAmount) >= money())
+	{
+		withdrawal(_withAmount);
+		return WITHDRAWN;
+	}
+	if ((getbalance() - _withAmount) >= -overdraftLimit)
+	{
+		withdrawal(_withAmount);
+		setbalance(getbalance() - overdraftFee);
+		recordEntry(LEDGER_OVERDRAFT_FEE, overdraftFee);
+		return WITHDRAWN_WITH_FEE;
+	}
+	return INSUFFICIENT_BALANCE;
+}
 #pragma endregion
@@ -1,8 +1,42 @@
 #pragma once
 #ifndef USERCLASSES
 #endif USERCLASSES // !USERCLASSES
+#include <cstdint>
 #include <iostream>
 #include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+#include "money.h"
+
+// Outcome of a withdrawal attempt, shared by the interactive menu and the batch processor
+enum withdrawalResult
+{
+	WITHDRAWN,
+	WITHDRAWN_WITH_FEE,
+	INVALID_AMOUNT,
+	INSUFFICIENT_BALANCE
+};
+
+// Kind of balance change a ledger entry records
+// Deposits and interest add their amount to the balance, withdrawals and overdraft fees subtract it
+enum ledgerEntryType : uint8_t
+{
+	LEDGER_DEPOSIT = 1,
+	LEDGER_WITHDRAWAL,
+	LEDGER_OVERDRAFT_FEE,
+	LEDGER_INTEREST
+};
+
+// ledgerEntry: one balance change of an account
+// timestamp is in seconds since the epoch, amount is the size of the change and balance is the balance after it
+struct ledgerEntry
+{
+	int64_t timestamp;
+	money amount;
+	money balance;
+	ledgerEntryType type;
+};
 
 // Customer class declaration
 class customer
@@ -13,6 +47,7 @@ public:
 	customer(std::string _firstname, std::string _lastName, std::string _address, std::string _phoneNum, std::string _email, std::string _username);
 
 	// Setters
+	// Take their argument by value so callers can move a string in
 	void setfirstName(std::string _firstName);
 	void setlastName(std::string _lastName);
 	void setaddress(std::string _address);
@@ -21,12 +56,12 @@ public:
 	void setusername(std::string _username);
 
 	// Getters
-	std::string getfirstName() const;
-	std::string getlastName() const;
-	std::string getaddress() const;
-	std::string getphoneNum() const;
-	std::string getemail() const;
-	std::string getusername() const;
+	const std::string& getfirstName() const;
+	const std::string& getlastName() const;
+	const std::string& getaddress() const;
+	const std::string& getphoneNum() const;
+	const std::string& getemail() const;
+	const std::string& getusername() const;
 
 	// Other functions
 	void printInfo() const;
@@ -41,62 +76,89 @@ private:
 	std::string username;
 };
 
+// customerHandle: a shared, read-only customer profile
+// The store keeps one per profile and every account of that profile points at it, so copying an account never copies the profile
+typedef std::shared_ptr<const customer> customerHandle;
+
 // Account class declaration
 class account
 {
 public:
 	// Constructors
 	account();
-	account(customer _accountCustomer, float _balance, int _id, int _depositCount, int _withdrawalCount);
+	account(customerHandle _accountCustomer, money _balance, int _id, int _depositCount, int _withdrawalCount);
 
 	// Setters
-	void setaccountCustomer(customer _accountCustomer);
-	void setbalance(float _balance);
+	// An empty handle stands for a blank customer
+	void setaccountCustomer(customerHandle _accountCustomer);
+	void setbalance(money _balance);
 	void setid(int _id);
 	void setdepositCount(int _depositCount);
 	void setwithdrawalCount(int _withdrawalCount);
 
 	// Getters
-	customer getaccountCustomer() const;
-	float getbalance() const;
+	const customer& getaccountCustomer() const;
+	const customerHandle& getcustomerHandle() const;
+	money getbalance() const;
 	int getid() const;
 	int getdepositCount() const;
 	int getwithdrawalCount() const;
+	// Changes made since the account was last written to the store, oldest first
+	const std::vector<ledgerEntry>& getpendingEntries() const;
 
 	// Other functions
 	void printInfo() const;
-	void deposit(float _depAmount);
-	void withdrawal(float _withAmount);
+	void deposit(money _depAmount);
+	void withdrawal(money _withAmount);
+	void clearpendingEntries();
+
+protected:
+	void recordEntry(ledgerEntryType _type, money _amount);
 
 private:
 	// Attributes
-	customer accountCustomer;
-	float balance;
+	customerHandle accountCustomer;
+	money balance;
 	int id;
 	int depositCount;
 	int withdrawalCount;
+	std::vector<ledgerEntry> pendingEntries;
 };
 
 // SavingAccount class declaration
+//
+// interestRate is a yearly rate compounded daily. Interest is not paid at fixed times but accrued lazily:
+// accrualDay is the day (counted from 1970-01-01 in UTC) interest was last added up to, and accrueInterest adds
+// everything earned since then. An accrualDay of 0 means the account has never accrued, so it starts from the next accrual.
+// deposit and applyWithdrawal accrue up to today first, so a balance change never moves interest between days.
 class savingAccount : public account
 {
 public:
 	// Constructors
 	savingAccount();
-	savingAccount(float _interestRate, customer _accountCustomer, float _balance, int _id, int _depositCount, int _withdrawalCount);
+	savingAccount(fixedRate _interestRate, customerHandle _accountCustomer, money _balance, int _id, int _depositCount, int _withdrawalCount);
 
 	// Setters
-	void setinterestRate(float _interestRate);
+	void setinterestRate(fixedRate _interestRate);
+	void setaccrualDay(int64_t _accrualDay);
 
 	// Getters
-	float getinterestRate() const;
+	fixedRate getinterestRate() const;
+	int64_t getaccrualDay() const;
+	money getaccruedInterest(int64_t _day) const;
 
 	// Other functions
 	void printInfo() const;
-	void payInterest();
+	void accrueInterest(int64_t _day);
+	void deposit(money _depAmount);
+	withdrawalResult applyWithdrawal(money _withAmount);
+
+	static int64_t currentDay();
+	static const int daysPerYear = 365;
 private:
 	// Attributes
-	float interestRate;
+	fixedRate interestRate;
+	int64_t accrualDay;
 };
 
 // CheckingAccount class declaration
@@ -105,17 +167,21 @@ class checkingAccount : public account
 public:
 	// Constructors
 	checkingAccount();
-	checkingAccount(float _overdraftLimit, customer _accountCustomer, float _balance, int _id, int _depositCount, int _withdrawalCount);
+	checkingAccount(money _overdraftLimit, customerHandle _accountCustomer, money _balance, int _id, int _depositCount, int _withdrawalCount);
 
 	// Setters
-	void setoverdraftLimit(float _overdraftLimit);
+	void setoverdraftLimit(money _overdraftLimit);
 
 	// Getters
-	float getoverdraftLimit() const;
+	money getoverdraftLimit() const;
 
 	// Other functions
 	void printInfo() const;
+	withdrawalResult applyWithdrawal(money _withAmount);
+
+	// Fee charged when a withdrawal takes the balance below 0
+	static constexpr money overdraftFee = money::fromCents(500);
 private:
 	// Attributes
-	float overdraftLimit;
+	money overdraftLimit;
 };